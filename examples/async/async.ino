@@ -0,0 +1,119 @@
+/**!
+ * @file async.ino
+ * @brief Asynchronous sending example
+ * @details API calls only queue their frames and return at once, lcd.poll() in loop() sends them in the background.
+ * @n  The sketch samples a "sensor" every 5 ms while refreshing a dashboard, and prints the longest loop() time
+ * @n  and the queue depth once per second.
+ * @n  Most parameters are related to the screen size (320*240). Please ensure that the custom parameters do not exceed the screen limits.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [fengli](li.feng@dfrobot.com)
+ * @maintainer [qsjhyy](yihuan.huang@dfrobot.com)
+ * @maintainer [GDuang](yonglei.ren@dfrobot.com)
+ * @version  V2.0
+ * @date  2024-03-19
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "DFRobot_LcdDisplay.h"
+
+#if LCD_DISABLE_ASYNC
+  // Off by default on AVR boards to save RAM: build the library and the sketch with -DLCD_DISABLE_ASYNC=0
+  #error "This example needs asynchronous sending, build with -DLCD_DISABLE_ASYNC=0"
+#endif
+
+#define I2C_COMMUNICATION  // I2C communication. If you want to use UART communication, comment out this line of code.
+
+#ifdef  I2C_COMMUNICATION
+  /**
+    * Using the I2C interface.
+    */
+  DFRobot_Lcd_IIC lcd(&Wire, /*I2CAddr*/ 0x2c);
+#else
+  /**
+    * Using the UART interface.
+    */
+  #if ((defined ARDUINO_AVR_UNO) || (defined ESP8266) || (defined ARDUINO_BBC_MICROBIT_V2))
+    #include <SoftwareSerial.h>
+    SoftwareSerial softSerial(/*rx =*/4, /*tx =*/5);
+    #define FPSerial softSerial
+  #else
+    #define FPSerial Serial1
+  #endif
+  DFRobot_Lcd_UART lcd(FPSerial);
+#endif
+
+#define WIDGET_NUM  4
+
+uint8_t barId[WIDGET_NUM];
+uint8_t gaugeId;
+uint16_t samples = 0;
+unsigned long lastSample = 0, lastReport = 0, maxLoopTime = 0;
+
+void setup(void)
+{
+  #ifndef  I2C_COMMUNICATION
+    #if (defined ESP32)
+      FPSerial.begin(9600, SERIAL_8N1, /*rx =*/D2, /*tx =*/D3);
+    #else
+      FPSerial.begin(9600);
+    #endif
+  #endif
+
+  Serial.begin(115200);
+
+  lcd.begin();
+  lcd.setBackgroundColor(BLACK);
+  lcd.cleanScreen();
+  delay(500);
+
+  for (uint8_t i = 0; i < WIDGET_NUM; i++) {
+    barId[i] = lcd.creatBar(10, 10 + i * 30, 140, 15, GREEN);
+  }
+  gaugeId = lcd.creatGauge(170, 10, 140, 0, 100, RED, WHITE);
+
+  /**
+   * From now on API calls return at once.
+   * eQueueBlock    wait for room when the queue is full
+   * eQueueDrop     discard the new frame when the queue is full
+   * eQueueCoalesce overwrite a queued frame of the same control when the queue is full
+   */
+  lcd.setAsync(true, lcd.eQueueCoalesce);
+}
+
+void loop(void)
+{
+  unsigned long start = micros();
+
+  // Sample the "sensor" every 5 ms and show it on every control
+  if (millis() - lastSample >= 5) {
+    lastSample = millis();
+    samples++;
+    uint16_t value = analogRead(A0) % 101;
+    for (uint8_t i = 0; i < WIDGET_NUM; i++) {
+      lcd.setBarValue(barId[i], value);
+    }
+    lcd.setGaugeValue(gaugeId, value);
+  }
+
+  // Send queued frames without blocking
+  lcd.poll();
+
+  unsigned long loopTime = micros() - start;
+  if (loopTime > maxLoopTime) {
+    maxLoopTime = loopTime;
+  }
+
+  if (millis() - lastReport >= 1000) {
+    lastReport = millis();
+    Serial.print("samples/s: ");
+    Serial.print(samples);
+    Serial.print(", longest loop: ");
+    Serial.print(maxLoopTime);
+    Serial.print(" us, queued frames: ");
+    Serial.print(lcd.queueDepth());
+    Serial.print(", saved writes: ");
+    Serial.println(lcd.getCoalescedCount());
+    samples = 0;
+    maxLoopTime = 0;
+  }
+}
@@ -0,0 +1,106 @@
+/**!
+ * @file batch.ino
+ * @brief Batch mode example
+ * @details Refreshes a dashboard of six progress bars and six labels, first command by command,
+ * @n  then packed into one batch with beginBatch()/endBatch(), and prints how many commands per second each mode reaches.
+ * @n  Most parameters are related to the screen size (320*240). Please ensure that the custom parameters do not exceed the screen limits.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [fengli](li.feng@dfrobot.com)
+ * @maintainer [qsjhyy](yihuan.huang@dfrobot.com)
+ * @maintainer [GDuang](yonglei.ren@dfrobot.com)
+ * @version  V2.0
+ * @date  2024-03-19
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "DFRobot_LcdDisplay.h"
+
+#if LCD_DISABLE_BATCH
+  // Off by default on AVR boards to save RAM: build the library and the sketch with -DLCD_DISABLE_BATCH=0
+  #error "This example needs batch mode, build with -DLCD_DISABLE_BATCH=0"
+#endif
+
+#define I2C_COMMUNICATION  // I2C communication. If you want to use UART communication, comment out this line of code.
+
+#ifdef  I2C_COMMUNICATION
+  /**
+    * Using the I2C interface.
+    */
+  DFRobot_Lcd_IIC lcd(&Wire, /*I2CAddr*/ 0x2c);
+#else
+  /**
+    * Using the UART interface.
+    */
+  #if ((defined ARDUINO_AVR_UNO) || (defined ESP8266) || (defined ARDUINO_BBC_MICROBIT_V2))
+    #include <SoftwareSerial.h>
+    SoftwareSerial softSerial(/*rx =*/4, /*tx =*/5);
+    #define FPSerial softSerial
+  #else
+    #define FPSerial Serial1
+  #endif
+  DFRobot_Lcd_UART lcd(FPSerial);
+#endif
+
+#define WIDGET_NUM  6
+
+uint8_t barId[WIDGET_NUM];
+uint8_t labelId[WIDGET_NUM];
+
+// Refresh every widget once, two commands per widget
+void refresh(void)
+{
+  for (uint8_t i = 0; i < WIDGET_NUM; i++) {
+    uint8_t value = rand() % 100;
+    lcd.setBarValue(barId[i], value);
+    lcd.updateStringf(labelId[i], 260, 10 + i * 38, 0, WHITE, "%d", value);
+  }
+}
+
+// Print the number of commands sent per second
+void report(const char* mode, unsigned long ms)
+{
+  Serial.print(mode);
+  Serial.print(": ");
+  Serial.print(ms);
+  Serial.print(" ms, ");
+  Serial.print(WIDGET_NUM * 2 * 1000.0 / ms);
+  Serial.println(" commands/s");
+}
+
+void setup(void)
+{
+  #ifndef  I2C_COMMUNICATION
+    #if (defined ESP32)
+      FPSerial.begin(9600, SERIAL_8N1, /*rx =*/D2, /*tx =*/D3);
+    #else
+      FPSerial.begin(9600);
+    #endif
+  #endif
+
+  Serial.begin(115200);
+
+  lcd.begin();
+  lcd.setBackgroundColor(BLACK);
+  lcd.cleanScreen();
+  delay(500);
+
+  for (uint8_t i = 0; i < WIDGET_NUM; i++) {
+    barId[i] = lcd.creatBar(10, 10 + i * 38, 240, 20, GREEN);
+    labelId[i] = lcd.drawString(260, 10 + i * 38, "0", 0, WHITE);
+  }
+}
+
+void loop(void)
+{
+  unsigned long start = millis();
+  refresh();
+  report("immediate", millis() - start);
+  delay(1000);
+
+  start = millis();
+  lcd.beginBatch();
+  refresh();
+  lcd.endBatch();
+  report("batch", millis() - start);
+  delay(1000);
+}
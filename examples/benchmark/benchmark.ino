@@ -0,0 +1,194 @@
+/**!
+ * @file benchmark.ino
+ * @brief Per-API benchmark without a screen
+ * @details Calls every drawing method of the library many times against a fake serial port that counts
+ * @n  what is written and acknowledges each write at once, then prints one JSON document over Serial:
+ * @n  {"calls":1000,"results":[{"method":"drawPixel","encode_us":9.1,"bytes":17,"writes":1,"delay_ms":50}, ...]}
+ * @n  encode_us  mean time of one call with immediate acknowledgements, i.e. encoding and transport overhead
+ * @n             (plus the fixed settle time of cleanScreen(), setBackgroundColor(), creatChart() and updateLine())
+ * @n  bytes      bytes written per call
+ * @n  writes     bus transactions per call
+ * @n  delay_ms   time of one call without flow control, i.e. spent waiting in delay() for the module
+ * @n  The library itself allocates no heap memory; String arguments are built by the caller.
+ * @n  updateString(String) and updateStringf show what building the text as a String costs against formatting it into the frame.
+ * @n  Compare the output of two library versions to catch regressions in the encoders and transports.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [fengli](li.feng@dfrobot.com)
+ * @maintainer [qsjhyy](yihuan.huang@dfrobot.com)
+ * @maintainer [GDuang](yonglei.ren@dfrobot.com)
+ * @version  V2.0
+ * @date  2024-03-19
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "DFRobot_LcdDisplay.h"
+
+#ifdef __AVR__
+  #define BENCH_CALLS  100
+#else
+  #define BENCH_CALLS  1000
+#endif
+#define FEW_CALLS    3      // for calls with a long settle time, or whose IDs cannot be freed
+
+/**
+ * A serial port without a screen behind it: counts what is written and answers every write with
+ * an acknowledgement, so that flow control never waits.
+ */
+class FakeBus : public Stream
+{
+public:
+  uint32_t bytes = 0;
+  uint32_t writes = 0;
+
+  size_t write(uint8_t data)
+  {
+    return write(&data, 1);
+  }
+  size_t write(const uint8_t* pBuf, size_t len)
+  {
+    LCD_UNUSED(pBuf);
+    bytes += len;
+    writes++;
+    _ack = 0;
+    return len;
+  }
+  int available() { return sizeof(_ackFrame) - _ack; }
+  int read() { return (_ack < sizeof(_ackFrame)) ? _ackFrame[_ack++] : -1; }
+  int peek() { return (_ack < sizeof(_ackFrame)) ? _ackFrame[_ack] : -1; }
+  void flush() {}
+
+private:
+  const uint8_t _ackFrame[4] = {0x55, 0xAA, 0x01, 0x00};
+  uint8_t _ack = sizeof(_ackFrame);
+};
+
+FakeBus bus;
+DFRobot_Lcd_UART lcd(bus);
+
+uint8_t id, lineId, iconId, sliderId, barId, chartId, seriesId, gaugeId, compassId, meterId, textId;
+uint16_t points[8] = {10, 20, 30, 40, 50, 60, 70, 80};
+bool first = true;
+
+void none() {}
+
+/**
+ * Time call() over calls iterations; before() and after() prepare and clean up each iteration,
+ * for example create the object a delete call needs, and are not counted.
+ */
+void bench(const char* method, void (*call)(), void (*after)() = none, void (*before)() = none, uint16_t calls = BENCH_CALLS)
+{
+  unsigned long time = 0;
+  uint32_t bytes = 0, writes = 0;
+  for (uint16_t i = 0; i < calls; i++) {
+    before();
+    uint32_t b = bus.bytes, w = bus.writes;
+    unsigned long start = micros();
+    call();
+    time += micros() - start;
+    bytes += bus.bytes - b;
+    writes += bus.writes - w;
+    after();
+  }
+
+  // Once more without acknowledgements, paced by the fixed settle time like a plain sketch
+  before();
+  lcd.setFlowControl(false);
+  unsigned long start = millis();
+  call();
+  unsigned long paced = millis() - start;
+  lcd.setFlowControl(true);
+  after();
+
+  Serial.print(first ? "\n  " : ",\n  ");
+  first = false;
+  Serial.print("{\"method\":\"");
+  Serial.print(method);
+  Serial.print("\",\"encode_us\":");
+  Serial.print((float)time / calls, 2);
+  Serial.print(",\"bytes\":");
+  Serial.print((float)bytes / calls, 1);
+  Serial.print(",\"writes\":");
+  Serial.print((float)writes / calls, 1);
+  Serial.print(",\"delay_ms\":");
+  Serial.print(paced);
+  Serial.print("}");
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+  lcd.begin();
+  lcd.setFlowControl(true);
+
+  lineId = lcd.drawLine(10, 10, 100, 100, 2, RED);
+  iconId = lcd.drawIcon(10, 10, lcd.eIconBee, 128);
+  sliderId = lcd.creatSlider(10, 10, 100, 20, 0xF800);
+  barId = lcd.creatBar(10, 40, 100, 20, GREEN);
+  gaugeId = lcd.creatGauge(160, 10, 100, 0, 100, RED, WHITE);
+  compassId = lcd.creatCompass(160, 10, 100);
+  meterId = lcd.creatLineMeter(160, 120, 100, 0, 100, RED, WHITE);
+  textId = lcd.drawString(10, 200, "benchmark", 0, WHITE);
+  chartId = lcd.creatChart("x", "y", WHITE, 1);
+  seriesId = lcd.creatChartSeries(chartId, RED);
+
+  Serial.print("{\"calls\":");
+  Serial.print(BENCH_CALLS);
+  Serial.print(",\"results\":[");
+
+  bench("setBackgroundColor", []() { lcd.setBackgroundColor(BLACK); }, none, none, FEW_CALLS);
+  bench("setBackgroundImg", []() { lcd.setBackgroundImg(0, "bg.png"); });
+  bench("cleanScreen", []() { lcd.cleanScreen(); }, none, none, FEW_CALLS);
+  bench("drawPixel", []() { lcd.drawPixel(10, 10, RED); });
+  bench("drawLine", []() { id = lcd.drawLine(10, 10, 100, 100, 2, RED); }, []() { lcd.deleteLine(id); });
+  bench("updateLine", []() { lcd.updateLine(lineId, 20, 20, 120, 120, 3, BLUE); });
+  bench("deleteLine", []() { lcd.deleteLine(id); }, none, []() { id = lcd.drawLine(10, 10, 100, 100, 2, RED); });
+  bench("drawRect", []() { id = lcd.drawRect(10, 10, 100, 50, 2, RED, 1, BLUE, 1); }, []() { lcd.deleteRect(id); });
+  bench("updateRect", []() { lcd.updateRect(id, 20, 20, 100, 50, 2, RED, 1, BLUE, 0); }, []() { lcd.deleteRect(id); }, []() { id = lcd.drawRect(10, 10, 100, 50, 2, RED, 1, BLUE, 1); });
+  bench("drawCircle", []() { id = lcd.drawCircle(100, 100, 50, 2, RED, 1, BLUE); }, []() { lcd.deleteCircle(id); });
+  bench("updateCircle", []() { lcd.updateCircle(id, 110, 110, 40, 2, RED, 0, BLUE); }, []() { lcd.deleteCircle(id); }, []() { id = lcd.drawCircle(100, 100, 50, 2, RED, 1, BLUE); });
+  bench("drawTriangle", []() { id = lcd.drawTriangle(10, 10, 100, 10, 50, 80, 2, RED, 1, BLUE); }, []() { lcd.deleteTriangle(id); });
+  bench("updateTriangle", []() { lcd.updateTriangle(id, 20, 20, 110, 20, 60, 90, 2, RED, 0, BLUE); }, []() { lcd.deleteTriangle(id); }, []() { id = lcd.drawTriangle(10, 10, 100, 10, 50, 80, 2, RED, 1, BLUE); });
+  bench("drawIcon", []() { id = lcd.drawIcon(10, 10, lcd.eIconBee, 128); }, []() { lcd.deleteIcon(id); });
+  bench("drawIcon(path)", []() { id = lcd.drawIcon(10, 10, "S:/bee.png", 128); }, []() { lcd.deleteIcon(id); });
+  bench("setAngleIcon", []() { lcd.setAngleIcon(iconId, 90); });
+  bench("updateIcon", []() { lcd.updateIcon(iconId, 20, 20, lcd.eIconBee, 200); });
+  bench("updateIcon(path)", []() { lcd.updateIcon(iconId, 20, 20, "S:/bee.png", 200); });
+  bench("drawGif", []() { id = lcd.drawGif(10, 10, lcd.eGifSun, 128); }, []() { lcd.deleteGif(id); });
+  bench("drawGif(path)", []() { id = lcd.drawGif(10, 10, "S:/sun.gif", 128); }, []() { lcd.deleteGif(id); });
+  bench("creatSlider", []() { id = lcd.creatSlider(10, 10, 100, 20, 0xF800); }, []() { lcd.deleteSlider(id); });
+  bench("updateSlider", []() { lcd.updateSlider(sliderId, 20, 20, 100, 20, 0x001F); });
+  bench("setSliderValue", []() { lcd.setSliderValue(sliderId, 50); });
+  bench("creatBar", []() { id = lcd.creatBar(10, 40, 100, 20, GREEN); }, []() { lcd.deleteBar(id); });
+  bench("updateBar", []() { lcd.updateBar(barId, 20, 40, 100, 20, BLUE); });
+  bench("setBarValue", []() { lcd.setBarValue(barId, 50); });
+  bench("creatChart", []() { id = lcd.creatChart("x", "y", WHITE, 1); }, []() { lcd.deleteChart(id); }, none, FEW_CALLS);
+  bench("updateChart", []() { lcd.updateChart(chartId, BLACK, 2); });
+  bench("creatChartSeries", []() { id = lcd.creatChartSeries(chartId, BLUE); }, none, none, FEW_CALLS);
+  bench("updateChartSeries", []() { lcd.updateChartSeries(chartId, seriesId, GREEN); });
+  bench("addChartSeriesData", []() { lcd.addChartSeriesData(chartId, seriesId, points, 8); });
+  bench("updateChartPoint", []() { lcd.updateChartPoint(chartId, seriesId, 1, 50); });
+  bench("setTopChart", []() { lcd.setTopChart(chartId); });
+  bench("creatGauge", []() { id = lcd.creatGauge(160, 10, 100, 0, 100, RED, WHITE); }, []() { lcd.deleteGauge(id); });
+  bench("updateGauge", []() { lcd.updateGauge(gaugeId, 170, 10, 100, 0, 100, BLUE, WHITE); });
+  bench("setGaugeValue", []() { lcd.setGaugeValue(gaugeId, 50); });
+  bench("creatCompass", []() { id = lcd.creatCompass(160, 10, 100); }, []() { lcd.deleteCompass(id); });
+  bench("updateCompass", []() { lcd.updateCompass(compassId, 170, 10, 100); });
+  bench("setCompassScale", []() { lcd.setCompassScale(compassId, 900); });
+  bench("creatLineMeter", []() { id = lcd.creatLineMeter(160, 120, 100, 0, 100, RED, WHITE); }, []() { lcd.deleteLineMeter(id); });
+  bench("updateLineMeter", []() { lcd.updateLineMeter(meterId, 170, 120, 100, 0, 100, BLUE, WHITE); });
+  bench("setMeterValue", []() { lcd.setMeterValue(meterId, 50); });
+  bench("setTopLineMeter", []() { lcd.setTopLineMeter(meterId); });
+  bench("drawString", []() { id = lcd.drawString(10, 200, "benchmark", 0, WHITE); }, []() { lcd.deleteString(id); });
+  bench("updateString", []() { lcd.updateString(textId, 10, 200, "benchmark", 0, RED); });
+  bench("updateString(String)", []() { lcd.updateString(textId, 10, 200, String(millis()) + "ms", 0, RED); });
+  bench("drawStringf", []() { id = lcd.drawStringf(10, 200, 0, WHITE, "%lums", millis()); }, []() { lcd.deleteString(id); });
+  bench("updateStringf", []() { lcd.updateStringf(textId, 10, 200, 0, RED, "%lums", millis()); });
+  bench("drawLcdTime", []() { id = lcd.drawLcdTime(10, 200, 12, 34, 56, 0, 0xFFFF); }, []() { lcd.deleteString(id); });
+  bench("updateLcdTime", []() { lcd.updateLcdTime(textId, 10, 200, 12, 34, 56, 0, 0xFFFF); });
+
+  Serial.println("\n]}");
+}
+
+void loop(void)
+{
+}
@@ -0,0 +1,82 @@
+/**!
+ * @file clock.ino
+ * @brief Clock and date that only resend the fields that changed
+ * @details DFRobot_LcdClock keeps hours, minutes, seconds and the date as separate text objects, so
+ * @n  each second normally costs one short frame for the seconds instead of the whole "hh:mm:ss" text.
+ * @n  The time is counted with millis() here; see readRtc() for taking it from an RTC instead.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [fengli](li.feng@dfrobot.com)
+ * @maintainer [qsjhyy](yihuan.huang@dfrobot.com)
+ * @maintainer [GDuang](yonglei.ren@dfrobot.com)
+ * @version  V2.0
+ * @date  2024-03-19
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "DFRobot_LcdDisplay.h"
+
+#define I2C_COMMUNICATION  // I2C communication. If you want to use UART communication, comment out this line of code.
+#ifdef  I2C_COMMUNICATION
+ /**
+   * Using the I2C interface.
+   */
+DFRobot_Lcd_IIC lcd(&Wire, /*I2CAddr*/ 0x2c);
+#else
+ /**
+   * Using the UART interface.
+   */
+#if ((defined ARDUINO_AVR_UNO) || (defined ESP8266) || (defined ARDUINO_BBC_MICROBIT_V2))
+#include <SoftwareSerial.h>
+SoftwareSerial softSerial(/*rx =*/4, /*tx =*/5);
+#define FPSerial softSerial
+#else
+#define FPSerial Serial1
+#endif
+DFRobot_Lcd_UART lcd(FPSerial);
+#endif
+
+DFRobot_LcdClock lcdClock(lcd);
+
+/**
+ * Time source for an RTC: fill in the time read from the chip and pass it to lcdClock.setTimeSource(readRtc).
+ */
+void readRtc(DFRobot_LcdClock::sLcdClockTime_t* time)
+{
+  // e.g. with RTClib: DateTime now = rtc.now(); time->hour = now.hour(); ...
+  LCD_UNUSED(time);
+}
+
+void setup(void)
+{
+  #ifndef  I2C_COMMUNICATION
+    #if (defined ESP32)
+      FPSerial.begin(9600, SERIAL_8N1, /*rx =*/D2, /*tx =*/D3);
+    #else
+      FPSerial.begin(9600);
+    #endif
+  #endif
+
+  Serial.begin(115200);
+
+  lcd.begin();
+  lcd.setBackgroundColor(BLACK);
+  lcd.cleanScreen();
+  delay(500);
+
+  lcdClock.setDate(2024, 3, 29, 5);
+  lcdClock.setTime(23, 59, 50);
+  // lcdClock.setTimeSource(readRtc);
+
+  lcdClock.drawTime(10, 64, 0, LIGHTGREY);
+  lcdClock.drawDate(10, 100, 0, LIGHTGREY);
+}
+
+void loop(void)
+{
+  uint8_t frames = lcdClock.tick();
+  if (frames) {
+    Serial.print("frames sent: ");
+    Serial.println(frames);
+  }
+  delay(100);
+}
@@ -0,0 +1,98 @@
+/**!
+ * @file multiDisplay.ino
+ * @brief Several screens on one I2C bus
+ * @details Three modules at the I2C addresses 0x2c, 0x2d and 0x2e each show a progress bar.
+ * @n  The bars are first updated one screen after the other, then through a DFRobot_LcdGroup that sends to one
+ * @n  screen while the others are still processing, and the sketch prints how many frames per second each way reaches.
+ * @n  Finally the first screen mirrors everything to the other two, so all three show the same content.
+ * @n  Most parameters are related to the screen size (320*240). Please ensure that the custom parameters do not exceed the screen limits.
+ * @copyright  Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @license     The MIT License (MIT)
+ * @author [fengli](li.feng@dfrobot.com)
+ * @maintainer [qsjhyy](yihuan.huang@dfrobot.com)
+ * @maintainer [GDuang](yonglei.ren@dfrobot.com)
+ * @version  V2.0
+ * @date  2024-03-19
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "DFRobot_LcdDisplay.h"
+
+#if LCD_DISABLE_ASYNC
+  // Off by default on AVR boards to save RAM: build the library and the sketch with -DLCD_DISABLE_ASYNC=0
+  #error "This example needs asynchronous sending, build with -DLCD_DISABLE_ASYNC=0"
+#endif
+
+#define SCREEN_NUM  3
+#define ROUNDS      20
+
+DFRobot_Lcd_IIC lcd1(&Wire, /*I2CAddr*/ 0x2c);
+DFRobot_Lcd_IIC lcd2(&Wire, /*I2CAddr*/ 0x2d);
+DFRobot_Lcd_IIC lcd3(&Wire, /*I2CAddr*/ 0x2e);
+DFRobot_Lcd_IIC* screen[SCREEN_NUM] = {&lcd1, &lcd2, &lcd3};
+uint8_t barId[SCREEN_NUM];
+
+DFRobot_LcdGroup group;
+
+// Print the number of frames sent per second
+void report(const char* mode, unsigned long ms)
+{
+  Serial.print(mode);
+  Serial.print(": ");
+  Serial.print(ms);
+  Serial.print(" ms, ");
+  Serial.print(SCREEN_NUM * ROUNDS * 1000.0 / ms);
+  Serial.println(" frames/s");
+}
+
+void setup(void)
+{
+  Serial.begin(115200);
+
+  for (uint8_t i = 0; i < SCREEN_NUM; i++) {
+    while (!screen[i]->begin()) {
+      Serial.println("Screen not found, check the wiring and the I2C address!");
+      delay(1000);
+    }
+    screen[i]->setBackgroundColor(BLACK);
+    screen[i]->cleanScreen();
+    barId[i] = screen[i]->creatBar(10, 100, 300, 30, GREEN);
+  }
+
+  // One screen after the other: every frame is followed by the module's processing time
+  unsigned long start = millis();
+  for (uint8_t value = 0; value < ROUNDS; value++) {
+    for (uint8_t i = 0; i < SCREEN_NUM; i++) {
+      screen[i]->setBarValue(barId[i], value * 5);
+    }
+  }
+  report("sequential", millis() - start);
+
+  // Through the group: while one module processes, the next one is sent to
+  for (uint8_t i = 0; i < SCREEN_NUM; i++) {
+    group.add(*screen[i]);
+  }
+  start = millis();
+  for (uint8_t value = 0; value < ROUNDS; value++) {
+    for (uint8_t i = 0; i < SCREEN_NUM; i++) {
+      screen[i]->setBarValue(barId[i], 100 - value * 5);
+    }
+    group.flush();
+  }
+  report("group", millis() - start);
+
+  // Mirror mode: lcd1 encodes once and sends each transaction to all three addresses
+  for (uint8_t i = 0; i < SCREEN_NUM; i++) {
+    screen[i]->setAsync(false);
+    screen[i]->cleanScreen();
+  }
+  lcd1.addMirror(0x2d);
+  lcd1.addMirror(0x2e);
+  barId[0] = lcd1.creatBar(10, 100, 300, 30, GREEN);
+}
+
+void loop(void)
+{
+  for (uint8_t value = 0; value <= 100; value += 10) {
+    lcd1.setBarValue(barId[0], value);
+  }
+}
@@ -54,22 +54,22 @@ void flash()   //Interrupt handler that handles changes in time
 
 void setLux(uint8_t value){
   lcd.setBarValue(bar1, value);
-  lcd.updateString(labelId1, 260, 22, String(value)+"lux", 0, ORANGE);
+  lcd.updateStringf(labelId1, 260, 22, 0, ORANGE, "%dlux", value);
 }
 
 void setTemp(uint8_t value){
   lcd.setBarValue(bar2, value);
-  lcd.updateString(labelId2, 260, 62, String(value)+"°C", 0, RED);
+  lcd.updateStringf(labelId2, 260, 62, 0, RED, "%d°C", value);
 }
 
 void setHum(uint8_t value){
   lcd.setBarValue(bar3, value);
-  lcd.updateString(labelId3, 260, 102, String(value)+"%", 0, BLUE);
+  lcd.updateStringf(labelId3, 260, 102, 0, BLUE, "%d%%", value);
 }
 
 void setWind(uint8_t value){
   lcd.setBarValue(bar4, value);
-  lcd.updateString(labelId4, 260, 142, String(value)+"m/s", 0, GREEN);
+  lcd.updateStringf(labelId4, 260, 142, 0, GREEN, "%dm/s", value);
 }
 
 /**
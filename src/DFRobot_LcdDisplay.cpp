@@ -12,15 +12,84 @@
  * @url https://github.com/DFRobot/DFRobot_LcdDisplay
  */
 #include "DFRobot_LcdDisplay.h"
+#ifdef ARDUINO
 #include <Wire.h>
 #include <Arduino.h>
+#endif
 
 uint8_t wordLen[10];
 
-DFRobot_LcdDisplay::DFRobot_LcdDisplay()
+// Field layouts of the fixed-length draw frames; each draw/update pair shares one, see sendFields()
+static constexpr uint32_t pixelLayout = lcdLayout(3, 2, 2);                              // color, x, y
+static constexpr uint32_t lineLayout = lcdLayout(1, 1, 3, 2, 2, 2, 2);                   // id, width, color, x0, y0, x1, y1
+static constexpr uint32_t rectLayout = lcdLayout(1, 1, 3, 1, 3, 1, 2, 2, 2, 2);          // id, border, color, fill, color, rounded, x, y, w, h
+static constexpr uint32_t circleLayout = lcdLayout(1, 1, 3, 1, 3, 2, 2, 2);              // id, border, color, fill, color, r, x, y
+static constexpr uint32_t triangleLayout = lcdLayout(1, 1, 3, 1, 3, 2, 2, 2, 2, 2, 2);   // id, border, color, fill, color, x0 ... y2
+static constexpr uint32_t imageLayout = lcdLayout(1, 2, 2, 2, 2);                        // id, number, size, x, y
+static constexpr uint32_t sliderLayout = lcdLayout(1, 3, 2, 2, 2, 2);                    // id, color, x, y, width, height (also bars)
+static constexpr uint32_t meterLayout = lcdLayout(1, 2, 2, 2, 3, 3, 2, 2);               // id, size, start, end, pointer, bg, x, y (gauges and line meters)
+static constexpr uint32_t compassLayout = lcdLayout(1, 2, 2, 2);                         // id, diameter, x, y
+static constexpr uint32_t chartLayout = lcdLayout(1, 1, 3);                              // id, type, background color
+static constexpr uint32_t seriesLayout = lcdLayout(1, 1, 3);                             // series id, chart id, color
+static constexpr uint32_t pointLayout = lcdLayout(1, 1, 1, 1, 2);                        // chart id, series id, 1 (single point), index, value
+
+// Fixed fields in front of the text of the variable-length frames, see sendText()
+static constexpr uint32_t textLayout = lcdLayout(1, 1, 3, 2, 2);                         // id, font size, color, x, y
+static constexpr uint32_t pathLayout = lcdLayout(1, 2, 2, 2);                            // id, zoom, x, y
+static constexpr uint32_t backgroundLayout = lcdLayout(1);                               // location
+static constexpr uint32_t axisLayout = lcdLayout(1, 1);                                  // chart id, axis
+
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(textLayout) <= LCD_TEXT_HEAD_MAX_LEN, "text layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(pathLayout) <= LCD_TEXT_HEAD_MAX_LEN, "path layout");
+
+// The pixel frame ends in reserved zero bytes
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(pixelLayout) <= CMD_DRAW_PIXEL_LEN, "pixel layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(lineLayout) == CMD_DRAW_LINE_LEN, "line layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(rectLayout) == CMD_OF_DRAW_RECT_LEN, "rect layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(circleLayout) == CMD_OF_DRAW_CIRCLE_LEN, "circle layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(triangleLayout) == CMD_OF_DRAW_TRIANGLE_LEN, "triangle layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(imageLayout) == CMD_OF_DRAW_ICON_INTERNAL_LEN, "icon layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(imageLayout) == CMD_OF_DRAW_GIF_INTERNAL_LEN, "gif layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(sliderLayout) == CMD_OF_DRAW_SLIDER_LEN, "slider layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(sliderLayout) == CMD_OF_DRAW_BAR_LEN, "bar layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(meterLayout) == CMD_OF_DRAW_GAUGE_LEN, "gauge layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(meterLayout) == CMD_OF_DRAW_LINE_METER_LEN, "line meter layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(compassLayout) == CMD_DRAW_COMPASS_LEN, "compass layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(chartLayout) == CMD_DRAW_CHART_LEN, "chart layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(seriesLayout) == CMD_DRAW_SERIE_LEN, "series layout");
+static_assert(CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(pointLayout) == CMD_DRAW_SERIE_POINT_LEN, "chart point layout");
+
+#if !LCD_DISABLE_TEXT
+// Append v in decimal, with a leading 0 below 10
+static char* appendNumber(char* p, uint8_t v)
 {
+  if (v >= 100) {
+    *p++ = '0' + v / 100;
+  }
+  *p++ = '0' + v / 10 % 10;
+  *p++ = '0' + v % 10;
+  return p;
+}
+
+static char* appendText(char* p, const char* str)
+{
+  uint8_t len = strlen(str);
+  memcpy(p, str, len);
+  return p + len;
 }
 
+// hh:mm:ss into buf, at least 11 bytes; returns the length
+static uint16_t formatTime(char* buf, uint8_t hour, uint8_t minute, uint8_t seconds)
+{
+  char* p = appendNumber(buf, hour);
+  *p++ = ':';
+  p = appendNumber(p, minute);
+  *p++ = ':';
+  p = appendNumber(p, seconds);
+  return p - buf;
+}
+#endif
+
 bool DFRobot_LcdDisplay::begin()
 {
   return true;
@@ -28,1078 +97,826 @@ bool DFRobot_LcdDisplay::begin()
 
 void DFRobot_LcdDisplay::drawPixel(int16_t x, int16_t y, uint32_t color)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_PIXEL, CMD_DRAW_PIXEL_LEN);
   if (320 <= x) {
     x = 319;
   }
   if (240 <= y) {
     y = 239;
   }
-  cmd[4] = color >> 16;
-  cmd[5] = color >> 8;
-  cmd[6] = color & 0xFF;
-  cmd[7] = x >> 8;
-  cmd[8] = x & 0xFF;
-  cmd[9] = y >> 8;
-  cmd[10] = y & 0xFF;
-  /*
-  cmd[4] = x >> 8;
-  cmd[5] = x & 0xFF;
-  cmd[6] = y >> 8;
-  cmd[7] = y & 0xFF;
-  cmd[8] = color >> 16;
-  cmd[9] = color >> 8;
-  cmd[10] = color & 0xFF;
-  */
-  writeCommand(cmd, CMD_DRAW_PIXEL_LEN);
-  free(cmd);
+  const uint32_t fields[] = {color, (uint16_t)x, (uint16_t)y};
+  sendFields(CMD_OF_DRAW_PIXEL, CMD_DRAW_PIXEL_LEN, pixelLayout, fields);
 }
 
 void DFRobot_LcdDisplay::cleanScreen()
 {
-  uint8_t* cmd = creatCommand(0x1D, 0x04);
-  writeCommand(cmd, 4);
-  delay(1500);
-  free(cmd);
+  uint8_t cmd[0x04];
+  creatCommand(cmd, 0x1D, 0x04);
+  sendCommand(cmd, 4, 1500);
 }
 
 uint8_t DFRobot_LcdDisplay::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t width, uint32_t color)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_LINE, CMD_DRAW_LINE_LEN);
   uint8_t id = getID(CMD_OF_DRAW_LINE);
-  cmd[4] = id;
-  cmd[5] = width;
-  cmd[6] = color >> 16;
-  cmd[7] = color >> 8;
-  cmd[8] = color & 0xFF;
-  cmd[9] = x0 >> 8;
-  cmd[10] = x0 & 0xFF;
-  cmd[11] = y0 >> 8;
-  cmd[12] = y0 & 0xFF;
-  cmd[13] = x1 >> 8;
-  cmd[14] = x1 & 0xFF;
-  cmd[15] = y1 >> 8;
-  cmd[16] = y1 & 0xFF;
-  writeCommand(cmd, CMD_DRAW_LINE_LEN);
-  free(cmd);
+  if (id == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {id, width, color, (uint16_t)x0, (uint16_t)y0, (uint16_t)x1, (uint16_t)y1};
+  sendFields(CMD_OF_DRAW_LINE, CMD_DRAW_LINE_LEN, lineLayout, fields);
   return id;
 }
 
-void DFRobot_LcdDisplay::updateLine(uint8_t id, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t width, uint32_t color){
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_LINE, CMD_DRAW_LINE_LEN);
-  cmd[4] = id;
-  cmd[5] = width;
-  cmd[6] = color >> 16;
-  cmd[7] = color >> 8;
-  cmd[8] = color & 0xFF;
-  cmd[9] = x0 >> 8;
-  cmd[10] = x0 & 0xFF;
-  cmd[11] = y0 >> 8;
-  cmd[12] = y0 & 0xFF;
-  cmd[13] = x1 >> 8;
-  cmd[14] = x1 & 0xFF;
-  cmd[15] = y1 >> 8;
-  cmd[16] = y1 & 0xFF;
-  writeCommand(cmd, CMD_DRAW_LINE_LEN);
-  delay(10);
-  free(cmd);
+void DFRobot_LcdDisplay::updateLine(uint8_t id, int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t width, uint32_t color)
+{
+  const uint32_t fields[] = {id, width, color, (uint16_t)x0, (uint16_t)y0, (uint16_t)x1, (uint16_t)y1};
+  sendFields(CMD_OF_DRAW_LINE, CMD_DRAW_LINE_LEN, lineLayout, fields, 10);
 }
 
 void DFRobot_LcdDisplay::deleteLine(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
+  uint8_t cmd[CMD_DELETE_OBJ_LEN];
+  creatCommand(cmd, CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_LINE;
   cmd[5] = id;
-  writeCommand(cmd, CMD_DELETE_OBJ_LEN);
-  free(cmd);
-  deleteNodeByID((GenericNode**)&line_head,id);
+  sendCommand(cmd, CMD_DELETE_OBJ_LEN);
+  freeID(CMD_OF_DRAW_LINE, id);
 }
 
 uint8_t DFRobot_LcdDisplay::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t borderWidth, uint32_t borderColor, uint8_t fill, uint32_t fillColor, uint8_t rounded)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_RECT, CMD_OF_DRAW_RECT_LEN);
   uint8_t id = getID(CMD_OF_DRAW_RECT);
-  cmd[4] = id;
-  cmd[5] = borderWidth;
-  cmd[6] = borderColor >> 16;
-  cmd[7] = borderColor >> 8;
-  cmd[8] = borderColor & 0xFF;
-  cmd[9] = fill;
-  cmd[10] = fillColor >> 16;
-  cmd[11] = fillColor >> 8;
-  cmd[12] = fillColor & 0xFF;
-  cmd[13] = rounded;
-  cmd[14] = x >> 8;
-  cmd[15] = x & 0xFF;
-  cmd[16] = y >> 8;
-  cmd[17] = y & 0xFF;
-  cmd[18] = w >> 8;
-  cmd[19] = w & 0xFF;
-  cmd[20] = h >> 8;
-  cmd[21] = h & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_RECT_LEN);
-  free(cmd);
+  if (id == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {id, borderWidth, borderColor, fill, fillColor, rounded, (uint16_t)x, (uint16_t)y, (uint16_t)w, (uint16_t)h};
+  sendFields(CMD_OF_DRAW_RECT, CMD_OF_DRAW_RECT_LEN, rectLayout, fields);
   return id;
 }
 
 void DFRobot_LcdDisplay::updateRect(uint8_t id, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t borderWidth, uint32_t borderColor, uint8_t fill, uint32_t fillColor, uint8_t rounded)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_RECT, CMD_OF_DRAW_RECT_LEN);
-  cmd[4] = id;
-  cmd[5] = borderWidth;
-  cmd[6] = borderColor >> 16;
-  cmd[7] = borderColor >> 8;
-  cmd[8] = borderColor & 0xFF;
-  cmd[9] = fill;
-  cmd[10] = fillColor >> 16;
-  cmd[11] = fillColor >> 8;
-  cmd[12] = fillColor & 0xFF;
-  cmd[13] = rounded;
-  cmd[14] = x >> 8;
-  cmd[15] = x & 0xFF;
-  cmd[16] = y >> 8;
-  cmd[17] = y & 0xFF;
-  cmd[18] = w >> 8;
-  cmd[19] = w & 0xFF;
-  cmd[20] = h >> 8;
-  cmd[21] = h & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_RECT_LEN);
-  free(cmd);
+  const uint32_t fields[] = {id, borderWidth, borderColor, fill, fillColor, rounded, (uint16_t)x, (uint16_t)y, (uint16_t)w, (uint16_t)h};
+  sendFields(CMD_OF_DRAW_RECT, CMD_OF_DRAW_RECT_LEN, rectLayout, fields);
 }
 
 void DFRobot_LcdDisplay::deleteRect(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
+  uint8_t cmd[CMD_DELETE_OBJ_LEN];
+  creatCommand(cmd, CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_RECT;
   cmd[5] = id;
-  writeCommand(cmd, CMD_DELETE_OBJ_LEN);
-  free(cmd);
-  deleteNodeByID((GenericNode**)&rect_head,id);
+  sendCommand(cmd, CMD_DELETE_OBJ_LEN);
+  freeID(CMD_OF_DRAW_RECT, id);
 }
 
 uint8_t DFRobot_LcdDisplay::drawCircle(int16_t x, int16_t y, int16_t r, uint8_t borderWidth, uint32_t borderColor, uint8_t fill, uint32_t fillColor)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_CIRCLE, CMD_OF_DRAW_CIRCLE_LEN);
   uint8_t id = getID(CMD_OF_DRAW_CIRCLE);
-  cmd[4] = id;
-  cmd[5] = borderWidth;
-  cmd[6] = borderColor >> 16;
-  cmd[7] = borderColor >> 8;
-  cmd[8] = borderColor & 0xFF;
-  cmd[9] = fill;
-  cmd[10] = fillColor >> 16;
-  cmd[11] = fillColor >> 8;
-  cmd[12] = fillColor & 0xFF;
-  cmd[13] = r >> 8;
-  cmd[14] = r & 0xFF;
-  cmd[15] = x >> 8;
-  cmd[16] = x & 0xFF;
-  cmd[17] = y >> 8;
-  cmd[18] = y & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_CIRCLE_LEN);
-  free(cmd);
+  if (id == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {id, borderWidth, borderColor, fill, fillColor, (uint16_t)r, (uint16_t)x, (uint16_t)y};
+  sendFields(CMD_OF_DRAW_CIRCLE, CMD_OF_DRAW_CIRCLE_LEN, circleLayout, fields);
   return id;
 }
 
 void DFRobot_LcdDisplay::updateCircle(uint8_t id, int16_t x, int16_t y, int16_t r, uint8_t borderWidth, uint32_t borderColor, uint8_t fill, uint32_t fillColor)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_CIRCLE, CMD_OF_DRAW_CIRCLE_LEN);
-  cmd[4] = id;
-  cmd[5] = borderWidth;
-  cmd[6] = borderColor >> 16;
-  cmd[7] = borderColor >> 8;
-  cmd[8] = borderColor & 0xFF;
-  cmd[9] = fill;
-  cmd[10] = fillColor >> 16;
-  cmd[11] = fillColor >> 8;
-  cmd[12] = fillColor & 0xFF;
-  cmd[13] = r >> 8;
-  cmd[14] = r & 0xFF;
-  cmd[15] = x >> 8;
-  cmd[16] = x & 0xFF;
-  cmd[17] = y >> 8;
-  cmd[18] = y & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_CIRCLE_LEN);
-  free(cmd);
+  const uint32_t fields[] = {id, borderWidth, borderColor, fill, fillColor, (uint16_t)r, (uint16_t)x, (uint16_t)y};
+  sendFields(CMD_OF_DRAW_CIRCLE, CMD_OF_DRAW_CIRCLE_LEN, circleLayout, fields);
 }
 
 void DFRobot_LcdDisplay::deleteCircle(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
+  uint8_t cmd[CMD_DELETE_OBJ_LEN];
+  creatCommand(cmd, CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_CIRCLE;
   cmd[5] = id;
-  writeCommand(cmd, CMD_DELETE_OBJ_LEN);
-  free(cmd);
-  deleteNodeByID((GenericNode**)&circle_head,id);
+  sendCommand(cmd, CMD_DELETE_OBJ_LEN);
+  freeID(CMD_OF_DRAW_CIRCLE, id);
 }
 
 uint8_t DFRobot_LcdDisplay::drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
   int16_t x2, int16_t y2, uint8_t borderWidth, uint32_t borderColor, uint8_t fill, uint32_t fillColor)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_TRIANGLE, CMD_OF_DRAW_TRIANGLE_LEN);
   uint8_t id = getID(CMD_OF_DRAW_TRIANGLE);
-  cmd[4] = id;
-  cmd[5] = borderWidth;
-  cmd[6] = borderColor >> 16;
-  cmd[7] = borderColor >> 8;
-  cmd[8] = borderColor & 0xFF;
-  cmd[9] = fill;
-  cmd[10] = fillColor >> 16;
-  cmd[11] = fillColor >> 8;
-  cmd[12] = fillColor & 0xFF;
-  cmd[13] = x0 >> 8;
-  cmd[14] = x0 & 0xFF;
-  cmd[15] = y0 >> 8;
-  cmd[16] = y0 & 0xFF;
-  cmd[17] = x1 >> 8;
-  cmd[18] = x1 & 0xFF;
-  cmd[19] = y1 >> 8;
-  cmd[20] = y1 & 0xFF;
-  cmd[21] = x2 >> 8;
-  cmd[22] = x2 & 0xFF;
-  cmd[23] = y2 >> 8;
-  cmd[24] = y2 & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_TRIANGLE_LEN);
-  free(cmd);
+  if (id == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {id, borderWidth, borderColor, fill, fillColor,
+    (uint16_t)x0, (uint16_t)y0, (uint16_t)x1, (uint16_t)y1, (uint16_t)x2, (uint16_t)y2};
+  sendFields(CMD_OF_DRAW_TRIANGLE, CMD_OF_DRAW_TRIANGLE_LEN, triangleLayout, fields);
   return id;
 }
 
 void DFRobot_LcdDisplay::updateTriangle(uint8_t id, int16_t x0, int16_t y0, int16_t x1, int16_t y1,
   int16_t x2, int16_t y2, uint8_t borderWidth, uint32_t borderColor, uint8_t fill, uint32_t fillColor)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_TRIANGLE, CMD_OF_DRAW_TRIANGLE_LEN);
-  cmd[4] = id;
-  cmd[5] = borderWidth;
-  cmd[6] = borderColor >> 16;
-  cmd[7] = borderColor >> 8;
-  cmd[8] = borderColor & 0xFF;
-  cmd[9] = fill;
-  cmd[10] = fillColor >> 16;
-  cmd[11] = fillColor >> 8;
-  cmd[12] = fillColor & 0xFF;
-  cmd[13] = x0 >> 8;
-  cmd[14] = x0 & 0xFF;
-  cmd[15] = y0 >> 8;
-  cmd[16] = y0 & 0xFF;
-  cmd[17] = x1 >> 8;
-  cmd[18] = x1 & 0xFF;
-  cmd[19] = y1 >> 8;
-  cmd[20] = y1 & 0xFF;
-  cmd[21] = x2 >> 8;
-  cmd[22] = x2 & 0xFF;
-  cmd[23] = y2 >> 8;
-  cmd[24] = y2 & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_TRIANGLE_LEN);
-  free(cmd);
+  const uint32_t fields[] = {id, borderWidth, borderColor, fill, fillColor,
+    (uint16_t)x0, (uint16_t)y0, (uint16_t)x1, (uint16_t)y1, (uint16_t)x2, (uint16_t)y2};
+  sendFields(CMD_OF_DRAW_TRIANGLE, CMD_OF_DRAW_TRIANGLE_LEN, triangleLayout, fields);
 }
 
 void DFRobot_LcdDisplay::deleteTriangle(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
+  uint8_t cmd[CMD_DELETE_OBJ_LEN];
+  creatCommand(cmd, CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_TRIANGLE;
   cmd[5] = id;
-  writeCommand(cmd, CMD_DELETE_OBJ_LEN);
-  free(cmd);
-  deleteNodeByID((GenericNode**)&triangle_head,id);
+  sendCommand(cmd, CMD_DELETE_OBJ_LEN);
+  freeID(CMD_OF_DRAW_TRIANGLE, id);
 }
 
 uint8_t DFRobot_LcdDisplay::drawIcon(int16_t x, int16_t y, uint16_t iconNum, uint16_t size)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_ICON_INTERNAL, CMD_OF_DRAW_ICON_INTERNAL_LEN);
   uint8_t id = getID(CMD_OF_DRAW_ICON_INTERNAL);
-  cmd[4] = id;
-  cmd[5] = iconNum >> 8;
-  cmd[6] = iconNum & 0xFF;
-  cmd[7] = size >> 8;
-  cmd[8] = size & 0xFF;
-  cmd[9] = x >> 8;
-  cmd[10] = x & 0xFF;
-  cmd[11] = y >> 8;
-  cmd[12] = y & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_ICON_INTERNAL_LEN);
-  free(cmd);
+  if (id == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {id, iconNum, size, (uint16_t)x, (uint16_t)y};
+  sendFields(CMD_OF_DRAW_ICON_INTERNAL, CMD_OF_DRAW_ICON_INTERNAL_LEN, imageLayout, fields);
   return id;
 }
 
-uint8_t DFRobot_LcdDisplay::drawIcon(int16_t x, int16_t y, String str, uint16_t zoom){
-  const char* data = str.c_str();
-  uint8_t length = strlen(data);
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_ICON_EXTERNAL, length + 11);
+#if !LCD_DISABLE_EXTERNAL_ICON
+uint8_t DFRobot_LcdDisplay::drawIcon(int16_t x, int16_t y, String str, uint16_t zoom)
+{
+  return drawIcon(x, y, str.c_str(), zoom);
+}
+
+uint8_t DFRobot_LcdDisplay::drawIcon(int16_t x, int16_t y, const char* str, uint16_t zoom)
+{
+  return drawIcon(x, y, str, strlen(str), zoom);
+}
+
+uint8_t DFRobot_LcdDisplay::drawIcon(int16_t x, int16_t y, const __FlashStringHelper* str, uint16_t zoom)
+{
+  const sLcdText_t text = {(const char*)str, (uint16_t)strlen_P((const char*)str), true};
+  return drawIcon(x, y, text, zoom);
+}
+
+uint8_t DFRobot_LcdDisplay::drawIcon(int16_t x, int16_t y, const char* str, uint16_t len, uint16_t zoom)
+{
+  const sLcdText_t text = {str, len, false};
+  return drawIcon(x, y, text, zoom);
+}
+
+uint8_t DFRobot_LcdDisplay::drawIcon(int16_t x, int16_t y, const sLcdText_t& text, uint16_t zoom)
+{
   uint8_t id = getID(CMD_OF_DRAW_ICON_INTERNAL);
-  cmd[4] = id;
-  cmd[5] = zoom >> 8;
-  cmd[6] = zoom & 0xFF;
-  cmd[7] = x >> 8;
-  cmd[8] = x & 0xFF;
-  cmd[9] = y >> 8;
-  cmd[10] = y & 0xFF;
-  memcpy(cmd+11, data, length);
-  writeCommand(cmd, length + 11);
-  free(cmd);
+  if (id == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {id, zoom, (uint16_t)x, (uint16_t)y};
+  sendText(CMD_OF_DRAW_ICON_EXTERNAL, pathLayout, fields, text);
   return id;
 }
+#endif
 
 void DFRobot_LcdDisplay::setAngleIcon(uint8_t id, int16_t angle){
-  uint8_t* cmd = creatCommand(CMD_SET_ANGLE_OBJ, CMD_SET_ANGLE_OBJ_LEN);
+  uint8_t cmd[CMD_SET_ANGLE_OBJ_LEN];
+  creatCommand(cmd, CMD_SET_ANGLE_OBJ, CMD_SET_ANGLE_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_ICON_INTERNAL;
   cmd[5] = id;
   cmd[6] = angle >> 8;
   cmd[7] = angle & 0xFF;
-  writeCommand(cmd, CMD_SET_ANGLE_OBJ_LEN);
-  free(cmd);
+  sendCommand(cmd, CMD_SET_ANGLE_OBJ_LEN);
 }
 
 void DFRobot_LcdDisplay::updateIcon(uint8_t iconId, int16_t x, int16_t y, uint16_t iconNum, uint16_t size)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_ICON_INTERNAL, CMD_OF_DRAW_ICON_INTERNAL_LEN);
-  cmd[4] = iconId;
-  cmd[5] = iconNum >> 8;
-  cmd[6] = iconNum & 0xFF;
-  cmd[7] = size >> 8;
-  cmd[8] = size & 0xFF;
-  cmd[9] = x >> 8;
-  cmd[10] = x & 0xFF;
-  cmd[11] = y >> 8;
-  cmd[12] = y & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_ICON_INTERNAL_LEN);
-  free(cmd);
-}
-
-void DFRobot_LcdDisplay::updateIcon(uint8_t iconId, int16_t x, int16_t y, String str, uint16_t zoom){
-  const char* data = str.c_str();
-  uint8_t length = strlen(data);
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_ICON_EXTERNAL, length + 11);
-  cmd[4] = iconId;
-  cmd[5] = zoom >> 8;
-  cmd[6] = zoom & 0xFF;
-  cmd[7] = x >> 8;
-  cmd[8] = x & 0xFF;
-  cmd[9] = y >> 8;
-  cmd[10] = y & 0xFF;
-  memcpy(cmd+11, data, length);
-  writeCommand(cmd, length + 11);
-  free(cmd);
+  const uint32_t fields[] = {iconId, iconNum, size, (uint16_t)x, (uint16_t)y};
+  sendFields(CMD_OF_DRAW_ICON_INTERNAL, CMD_OF_DRAW_ICON_INTERNAL_LEN, imageLayout, fields);
+}
+
+#if !LCD_DISABLE_EXTERNAL_ICON
+void DFRobot_LcdDisplay::updateIcon(uint8_t iconId, int16_t x, int16_t y, String str, uint16_t zoom)
+{
+  updateIcon(iconId, x, y, str.c_str(), zoom);
+}
+
+void DFRobot_LcdDisplay::updateIcon(uint8_t iconId, int16_t x, int16_t y, const char* str, uint16_t zoom)
+{
+  updateIcon(iconId, x, y, str, strlen(str), zoom);
+}
+
+void DFRobot_LcdDisplay::updateIcon(uint8_t iconId, int16_t x, int16_t y, const __FlashStringHelper* str, uint16_t zoom)
+{
+  const sLcdText_t text = {(const char*)str, (uint16_t)strlen_P((const char*)str), true};
+  updateIcon(iconId, x, y, text, zoom);
+}
+
+void DFRobot_LcdDisplay::updateIcon(uint8_t iconId, int16_t x, int16_t y, const char* str, uint16_t len, uint16_t zoom)
+{
+  const sLcdText_t text = {str, len, false};
+  updateIcon(iconId, x, y, text, zoom);
+}
+
+void DFRobot_LcdDisplay::updateIcon(uint8_t iconId, int16_t x, int16_t y, const sLcdText_t& text, uint16_t zoom)
+{
+  const uint32_t fields[] = {iconId, zoom, (uint16_t)x, (uint16_t)y};
+  sendText(CMD_OF_DRAW_ICON_EXTERNAL, pathLayout, fields, text);
 }
+#endif
 
 void DFRobot_LcdDisplay::deleteIcon(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
+  uint8_t cmd[CMD_DELETE_OBJ_LEN];
+  creatCommand(cmd, CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_ICON_INTERNAL;
   cmd[5] = id;
-  writeCommand(cmd, CMD_DELETE_OBJ_LEN);
-  free(cmd);
-  deleteNodeByID((GenericNode**)&icon_head, id);
+  sendCommand(cmd, CMD_DELETE_OBJ_LEN);
+  freeID(CMD_OF_DRAW_ICON_INTERNAL, id);
 }
 
+#if !LCD_DISABLE_GIF
 uint8_t DFRobot_LcdDisplay::drawGif(int16_t x, int16_t y, uint16_t gifNum, uint16_t size)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_GIF_INTERNAL, CMD_OF_DRAW_GIF_INTERNAL_LEN);
   uint8_t id = getID(CMD_OF_DRAW_GIF_INTERNAL);
-  cmd[4] = id;
-  cmd[5] = gifNum >> 8;
-  cmd[6] = gifNum & 0xFF;
-  cmd[7] = size >> 8;
-  cmd[8] = size & 0xFF;
-  cmd[9] = x >> 8;
-  cmd[10] = x & 0xFF;
-  cmd[11] = y >> 8;
-  cmd[12] = y & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_GIF_INTERNAL_LEN);
-  free(cmd);
+  if (id == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {id, gifNum, size, (uint16_t)x, (uint16_t)y};
+  sendFields(CMD_OF_DRAW_GIF_INTERNAL, CMD_OF_DRAW_GIF_INTERNAL_LEN, imageLayout, fields);
   return id;
 }
 
 uint8_t DFRobot_LcdDisplay::drawGif(int16_t x, int16_t y, String str, uint16_t zoom)
 {
-  const char* data = str.c_str();
-  uint8_t length = strlen(data);
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_GIF_EXTERNAL, length + 11);
+  return drawGif(x, y, str.c_str(), zoom);
+}
+
+uint8_t DFRobot_LcdDisplay::drawGif(int16_t x, int16_t y, const char* str, uint16_t zoom)
+{
+  return drawGif(x, y, str, strlen(str), zoom);
+}
+
+uint8_t DFRobot_LcdDisplay::drawGif(int16_t x, int16_t y, const __FlashStringHelper* str, uint16_t zoom)
+{
+  const sLcdText_t text = {(const char*)str, (uint16_t)strlen_P((const char*)str), true};
+  return drawGif(x, y, text, zoom);
+}
+
+uint8_t DFRobot_LcdDisplay::drawGif(int16_t x, int16_t y, const char* str, uint16_t len, uint16_t zoom)
+{
+  const sLcdText_t text = {str, len, false};
+  return drawGif(x, y, text, zoom);
+}
+
+uint8_t DFRobot_LcdDisplay::drawGif(int16_t x, int16_t y, const sLcdText_t& text, uint16_t zoom)
+{
   uint8_t id = getID(CMD_OF_DRAW_GIF_INTERNAL);
-  cmd[4] = id;
-  cmd[5] = zoom >> 8;
-  cmd[6] = zoom & 0xFF;
-  cmd[7] = x >> 8;
-  cmd[8] = x & 0xFF;
-  cmd[9] = y >> 8;
-  cmd[10] = y & 0xFF;
-  memcpy(cmd+11, data, length);
-  writeCommand(cmd, length + 11);
-  free(cmd);
+  if (id == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {id, zoom, (uint16_t)x, (uint16_t)y};
+  sendText(CMD_OF_DRAW_GIF_EXTERNAL, pathLayout, fields, text);
   return id;
 }
 
 void DFRobot_LcdDisplay::deleteGif(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
+  uint8_t cmd[CMD_DELETE_OBJ_LEN];
+  creatCommand(cmd, CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_GIF_INTERNAL;
   cmd[5] = id;
-  writeCommand(cmd, CMD_DELETE_OBJ_LEN);
-  free(cmd);
-  deleteNodeByID((GenericNode**)&gif_head, id);
+  sendCommand(cmd, CMD_DELETE_OBJ_LEN);
+  freeID(CMD_OF_DRAW_GIF_INTERNAL, id);
 }
+#endif
 
 uint8_t DFRobot_LcdDisplay::creatSlider(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_SLIDER, CMD_OF_DRAW_SLIDER_LEN);
   uint8_t id = getID(CMD_OF_DRAW_SLIDER);
-  cmd[4] = id;
-  cmd[5] = color >> 16;
-  cmd[6] = color >> 8;
-  cmd[7] = color & 0xFF;
-  cmd[8] = x >> 8;
-  cmd[9] = x & 0xFF;
-  cmd[10] = y >> 8;
-  cmd[11] = y & 0xFF;
-  cmd[12] = width >> 8;
-  cmd[13] = width & 0xFF;
-  cmd[14] = height >> 8;
-  cmd[15] = height & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_SLIDER_LEN);
-  free(cmd);
+  if (id == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {id, color, x, y, width, height};
+  sendFields(CMD_OF_DRAW_SLIDER, CMD_OF_DRAW_SLIDER_LEN, sliderLayout, fields);
   return id;
 }
 
 void DFRobot_LcdDisplay::updateSlider(uint8_t id, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_SLIDER, CMD_OF_DRAW_SLIDER_LEN);
-  cmd[4] = id;
-  cmd[5] = color >> 16;
-  cmd[6] = color >> 8;
-  cmd[7] = color & 0xFF;
-  cmd[8] = x >> 8;
-  cmd[9] = x & 0xFF;
-  cmd[10] = y >> 8;
-  cmd[11] = y & 0xFF;
-  cmd[12] = width >> 8;
-  cmd[13] = width & 0xFF;
-  cmd[14] = height >> 8;
-  cmd[15] = height & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_SLIDER_LEN);
-  free(cmd);
+  const uint32_t fields[] = {id, color, x, y, width, height};
+  sendFields(CMD_OF_DRAW_SLIDER, CMD_OF_DRAW_SLIDER_LEN, sliderLayout, fields);
 }
 
 void DFRobot_LcdDisplay::setSliderValue(uint8_t sliderId, uint16_t value)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_SLIDER_VALUE, CMD_SET_SLIDER_VALUE_LEN);
+  uint8_t cmd[CMD_SET_SLIDER_VALUE_LEN];
+  creatCommand(cmd, CMD_OF_DRAW_SLIDER_VALUE, CMD_SET_SLIDER_VALUE_LEN);
   cmd[4] = sliderId;
   cmd[5] = value >> 8;
   cmd[6] = value & 0xFF;
-  writeCommand(cmd, CMD_SET_SLIDER_VALUE_LEN);
-  free(cmd);
+  sendCommand(cmd, CMD_SET_SLIDER_VALUE_LEN);
 }
 
 void DFRobot_LcdDisplay::deleteSlider(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
+  uint8_t cmd[CMD_DELETE_OBJ_LEN];
+  creatCommand(cmd, CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_SLIDER;
   cmd[5] = id;
-  writeCommand(cmd, CMD_DELETE_OBJ_LEN);
-  free(cmd);
-  deleteNodeByID((GenericNode**)&slider_head, id);
+  sendCommand(cmd, CMD_DELETE_OBJ_LEN);
+  freeID(CMD_OF_DRAW_SLIDER, id);
 }
 
 uint8_t DFRobot_LcdDisplay::creatBar(uint16_t x, uint16_t y, uint16_t width, uint8_t height, uint32_t color)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_BAR, CMD_OF_DRAW_BAR_LEN);
   uint8_t id = getID(CMD_OF_DRAW_BAR);
-  cmd[4] = id;
-  cmd[5] = color >> 16;
-  cmd[6] = color >> 8;
-  cmd[7] = color & 0xFF;
-  cmd[8] = x >> 8;
-  cmd[9] = x & 0xFF;
-  cmd[10] = y >> 8;
-  cmd[11] = y & 0xFF;
-  cmd[12] = width >> 8;
-  cmd[13] = width & 0xFF;
-  cmd[14] = height >> 8;
-  cmd[15] = height & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_BAR_LEN);
-  free(cmd);
+  if (id == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {id, color, x, y, width, height};
+  sendFields(CMD_OF_DRAW_BAR, CMD_OF_DRAW_BAR_LEN, sliderLayout, fields);
   return id;
 }
 
 void DFRobot_LcdDisplay::updateBar(uint8_t id, uint16_t x, uint16_t y, uint16_t width, uint8_t height, uint32_t color)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_BAR, CMD_OF_DRAW_BAR_LEN);
-  cmd[4] = id;
-  cmd[5] = color >> 16;
-  cmd[6] = color >> 8;
-  cmd[7] = color & 0xFF;
-  cmd[8] = x >> 8;
-  cmd[9] = x & 0xFF;
-  cmd[10] = y >> 8;
-  cmd[11] = y & 0xFF;
-  cmd[12] = width >> 8;
-  cmd[13] = width & 0xFF;
-  cmd[14] = height >> 8;
-  cmd[15] = height & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_BAR_LEN);
-  free(cmd);
+  const uint32_t fields[] = {id, color, x, y, width, height};
+  sendFields(CMD_OF_DRAW_BAR, CMD_OF_DRAW_BAR_LEN, sliderLayout, fields);
 }
 
 void DFRobot_LcdDisplay::setBarValue(uint8_t barId, uint16_t value)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_BAR_VALUE, CMD_SET_BAR_VALUE_LEN);
-  if (cmd == NULL) {
-    DBG("cmd null");
-    return;
-  }
+  uint8_t cmd[CMD_SET_BAR_VALUE_LEN];
+  creatCommand(cmd, CMD_OF_DRAW_BAR_VALUE, CMD_SET_BAR_VALUE_LEN);
   cmd[4] = barId;
   cmd[5] = value >> 8;
   cmd[6] = value;
-  writeCommand(cmd, CMD_SET_BAR_VALUE_LEN);
-  free(cmd);
+  sendCommand(cmd, CMD_SET_BAR_VALUE_LEN);
 }
 
 void DFRobot_LcdDisplay::deleteBar(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
+  uint8_t cmd[CMD_DELETE_OBJ_LEN];
+  creatCommand(cmd, CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_BAR;
   cmd[5] = id;
-  writeCommand(cmd, CMD_DELETE_OBJ_LEN);
-  free(cmd);
-  deleteNodeByID((GenericNode**)&bar_head,id);
+  sendCommand(cmd, CMD_DELETE_OBJ_LEN);
+  freeID(CMD_OF_DRAW_BAR, id);
+}
+
+// Rows of _idMap, a disabled widget family has none
+enum {
+  eRowLine,
+  eRowRect,
+  eRowCircle,
+  eRowTriangle,
+  eRowIcon,
+#if !LCD_DISABLE_GIF
+  eRowGif,
+#endif
+  eRowSlider,
+  eRowBar,
+#if !LCD_DISABLE_METER
+  eRowGauge,
+  eRowCompass,
+  eRowLineMeter,
+#endif
+#if !LCD_DISABLE_TEXT
+  eRowText,
+#endif
+#if !LCD_DISABLE_CHART
+  eRowChart,
+  eRowSerie,
+#endif
+  eRowNum
+};
+static_assert(eRowNum == LCD_OBJECT_TYPE_NUM, "LCD_OBJECT_TYPE_NUM does not match the enabled widget families");
+
+int8_t DFRobot_LcdDisplay::objectIndex(uint8_t type)
+{
+  switch (type) {
+    case CMD_OF_DRAW_LINE:          return eRowLine;
+    case CMD_OF_DRAW_RECT:          return eRowRect;
+    case CMD_OF_DRAW_CIRCLE:        return eRowCircle;
+    case CMD_OF_DRAW_TRIANGLE:      return eRowTriangle;
+    case CMD_OF_DRAW_ICON_INTERNAL: return eRowIcon;
+#if !LCD_DISABLE_GIF
+    case CMD_OF_DRAW_GIF_INTERNAL:  return eRowGif;
+#endif
+    case CMD_OF_DRAW_SLIDER:        return eRowSlider;
+    case CMD_OF_DRAW_BAR:           return eRowBar;
+#if !LCD_DISABLE_METER
+    case CMD_OF_DRAW_GAUGE:         return eRowGauge;
+    case CMD_OF_DRAW_COMPASS:       return eRowCompass;
+    case CMD_OF_DRAW_LINE_METER:    return eRowLineMeter;
+#endif
+#if !LCD_DISABLE_TEXT
+    case CMD_OF_DRAW_TEXT:          return eRowText;
+#endif
+#if !LCD_DISABLE_CHART
+    case CMD_OF_DRAW_LINE_CHART:    return eRowChart;
+    case CMD_OF_DRAW_SERIE:         return eRowSerie;
+#endif
+    default:                        return -1;
+  }
 }
 
-uint8_t DFRobot_LcdDisplay:: getNewID(sGenericNode_t** head) {
-    uint8_t id = 1;
-    sGenericNode_t* temp = *head;
-    if(temp == NULL){}
-
-    while (temp) {
-        id = temp->id + 1; 
-        if (!temp->next) {
-            break;
-        }
-        temp = (sGenericNode_t*)temp->next;
+uint8_t DFRobot_LcdDisplay::getID(uint8_t type)
+{
+  int8_t index = objectIndex(type);
+  if (index < 0) {
+    return 0;
+  }
+  uint8_t* map = _idMap[index];
+  for (uint8_t i = 0; i < LCD_ID_MAP_LEN; i++) {
+    if (map[i] == 0xFF) {
+      continue;
     }
-
-    sGenericNode_t* new_node = (sGenericNode_t*)malloc(sizeof(sGenericNode_t));
-    if (new_node) {
-        new_node->id = id;
-        new_node->next = NULL;
-
-        if (temp) {
-            temp->next = new_node;
-        } else {
-            *head = new_node;
-        }
-    } else {
-        id = 0; 
+    uint8_t bit = __builtin_ctz((uint8_t)~map[i]);
+    uint16_t id = i * 8 + bit + 1;
+    if (id > LCD_MAX_OBJECT_ID) {
+      break;
     }
+    map[i] |= (1 << bit);
     return id;
+  }
+  _lastError = eLcdNoFreeID;
+  return 0;
 }
 
-void DFRobot_LcdDisplay::deleteNodeByID(sGenericNode_t** head, uint8_t id) {
-    if (head == NULL || *head == NULL) {
-        return;
-    }
-    sGenericNode_t* temp = *head;
-    sGenericNode_t* prev = NULL;
-
-    if (temp != NULL && temp->id == id) {
-        // *head = temp->next; 
-        *head = static_cast<DFRobot_LcdDisplay::sGenericNode_t*>(temp->next);
-        free(temp); 
-        if (*head == NULL) {
-            return;
-        }
-    } else {
-        while (temp != NULL && temp->id != id) {
-            prev = temp;
-            temp = (sGenericNode_t*)temp->next;
-        }
-        if (temp == NULL) return;
-
-        prev->next = temp->next;
-
-        free(temp);
-    }
-
-    if (*head == NULL) {
-        return;
-    }
-
-    temp = *head;
-    while (temp) {
-        if (temp->next != NULL) {
-            return; 
-        }
-        temp = (sGenericNode_t*)temp->next;
-    }
-    
-    *head = NULL;
-}
-
-uint8_t DFRobot_LcdDisplay::getID(uint8_t type)
+void DFRobot_LcdDisplay::freeID(uint8_t type, uint8_t id)
 {
-  LCD_UNUSED(type);
-  uint8_t id = 0;
-  switch(type){
-    case CMD_OF_DRAW_LINE_CHART:
-      id = getNewID((GenericNode**)&line_chart_head);
-      break;
-    case CMD_OF_DRAW_SERIE:
-      id = getNewID((GenericNode**)&series_head);
-      break;
-    case CMD_OF_DRAW_COMPASS:
-      id = getNewID((GenericNode**)&compass_head);
-      break;
-    case CMD_OF_DRAW_TEXT:
-      id = getNewID((GenericNode**)&text_head);
-      break;
-    case CMD_OF_DRAW_GAUGE:
-      id = getNewID((GenericNode**)&gauge_head);
-      break;
-    case CMD_OF_DRAW_LINE:
-      id = getNewID((GenericNode**)&line_head);
-      break;
-    case CMD_OF_DRAW_RECT:
-      id = getNewID((GenericNode**)&rect_head);
-      break;
-    case CMD_OF_DRAW_TRIANGLE:
-      id = getNewID((GenericNode**)&triangle_head);
-      break;
-    case CMD_OF_DRAW_CIRCLE:
-      id = getNewID((GenericNode**)&circle_head);
-      break;
-    case CMD_OF_DRAW_LINE_METER:
-      id = getNewID((GenericNode**)&lineMeter_head);
-      break;
-    case CMD_OF_DRAW_BAR:
-      id = getNewID((GenericNode**)&bar_head);
-      break;
-    case CMD_OF_DRAW_SLIDER:
-      id = getNewID((GenericNode**)&slider_head);
-      break;
-    case CMD_OF_DRAW_ICON_INTERNAL:
-      id = getNewID((GenericNode**)&icon_head);
-      break;
-    case CMD_OF_DRAW_GIF_INTERNAL:
-      id = getNewID((GenericNode**)&gif_head);
-      break;
-    default:
-      break;
+  int8_t index = objectIndex(type);
+  if ((index < 0) || (id == 0) || ((id - 1) / 8 >= LCD_ID_MAP_LEN)) {
+    return;
   }
-  return id;
+  _idMap[index][(id - 1) / 8] &= ~(1 << ((id - 1) % 8));
 }
 
+#if !LCD_DISABLE_METER
 uint8_t DFRobot_LcdDisplay::creatGauge(uint16_t x, uint16_t y, uint16_t diameter, uint16_t start, uint16_t end, uint32_t pointerColor, uint32_t bgColor)
 {
   uint8_t id = getID(CMD_OF_DRAW_GAUGE);
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_GAUGE, CMD_OF_DRAW_GAUGE_LEN);
-  cmd[4] = id;
-  cmd[5] = diameter >> 8;
-  cmd[6] = diameter & 0xFF;
-  cmd[7] = start >> 8;
-  cmd[8] = start & 0xFF;
-  cmd[9] = end >> 8;
-  cmd[10] = end & 0xFF;
-  cmd[11] = pointerColor >>16;
-  cmd[12] = pointerColor >> 8;
-  cmd[13] = pointerColor & 0xFF;
-  cmd[14] = bgColor >>16;
-  cmd[15] = bgColor >> 8;
-  cmd[16] = bgColor & 0xFF;
-  cmd[17] = x >> 8;
-  cmd[18] = x & 0xFF;
-  cmd[19] = y >> 8;
-  cmd[20] = y & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_GAUGE_LEN);
-  free(cmd);
- return id;
+  if (id == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {id, diameter, start, end, pointerColor, bgColor, x, y};
+  sendFields(CMD_OF_DRAW_GAUGE, CMD_OF_DRAW_GAUGE_LEN, meterLayout, fields);
+  return id;
 }
 
 void DFRobot_LcdDisplay::updateGauge(uint8_t id, uint16_t x, uint16_t y, uint16_t diameter, uint16_t start, uint16_t end, uint32_t pointerColor, uint32_t bgColor)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_GAUGE, CMD_OF_DRAW_GAUGE_LEN);
-  cmd[4] = id;
-  cmd[5] = diameter >> 8;
-  cmd[6] = diameter & 0xFF;
-  cmd[7] = start >> 8;
-  cmd[8] = start & 0xFF;
-  cmd[9] = end >> 8;
-  cmd[10] = end & 0xFF;
-  cmd[11] = pointerColor >>16;
-  cmd[12] = pointerColor >> 8;
-  cmd[13] = pointerColor & 0xFF;
-  cmd[14] = bgColor >>16;
-  cmd[15] = bgColor >> 8;
-  cmd[16] = bgColor & 0xFF;
-  cmd[17] = x >> 8;
-  cmd[18] = x & 0xFF;
-  cmd[19] = y >> 8;
-  cmd[20] = y & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_GAUGE_LEN);
-  free(cmd);
+  const uint32_t fields[] = {id, diameter, start, end, pointerColor, bgColor, x, y};
+  sendFields(CMD_OF_DRAW_GAUGE, CMD_OF_DRAW_GAUGE_LEN, meterLayout, fields);
 }
 
 void DFRobot_LcdDisplay::setGaugeValue(uint8_t gaugeId, uint16_t value)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_GAUGE_VALUE, CMD_SET_GAUGE_VALUE_LEN);
+  uint8_t cmd[CMD_SET_GAUGE_VALUE_LEN];
+  creatCommand(cmd, CMD_OF_DRAW_GAUGE_VALUE, CMD_SET_GAUGE_VALUE_LEN);
   cmd[4] = gaugeId;
   cmd[5] = value >> 8;
   cmd[6] = value & 0xFF;
-  writeCommand(cmd, CMD_SET_GAUGE_VALUE_LEN);
-  free(cmd);
+  sendCommand(cmd, CMD_SET_GAUGE_VALUE_LEN);
 }
 
 void DFRobot_LcdDisplay::deleteGauge(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
+  uint8_t cmd[CMD_DELETE_OBJ_LEN];
+  creatCommand(cmd, CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_GAUGE;
   cmd[5] = id;
-  writeCommand(cmd, CMD_DELETE_OBJ_LEN);
-  free(cmd);
-  deleteNodeByID((GenericNode**)&gauge_head,id);
+  sendCommand(cmd, CMD_DELETE_OBJ_LEN);
+  freeID(CMD_OF_DRAW_GAUGE, id);
 }
 
 uint8_t DFRobot_LcdDisplay::creatCompass(uint16_t x, uint16_t y, uint16_t diameter)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_COMPASS,CMD_DRAW_COMPASS_LEN);
   uint8_t compassId = getID(CMD_OF_DRAW_COMPASS);
-  cmd[4] = compassId;
-  cmd[5] = diameter >> 8;
-  cmd[6] = diameter & 0xFF;
-  cmd[7] = x >> 8;
-  cmd[8] = x & 0xFF;
-  cmd[9] = y >> 8;
-  cmd[10] = y & 0xFF;
-  writeCommand(cmd, CMD_DRAW_COMPASS_LEN);
-  free(cmd);
+  if (compassId == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {compassId, diameter, x, y};
+  sendFields(CMD_OF_DRAW_COMPASS, CMD_DRAW_COMPASS_LEN, compassLayout, fields);
   return compassId;
 }
 
 void DFRobot_LcdDisplay::updateCompass(uint8_t id, uint16_t x, uint16_t y, uint16_t diameter)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_COMPASS,CMD_DRAW_COMPASS_LEN);
-  cmd[4] = id;
-  cmd[5] = diameter >> 8;
-  cmd[6] = diameter & 0xFF;
-  cmd[7] = x >> 8;
-  cmd[8] = x & 0xFF;
-  cmd[9] = y >> 8;
-  cmd[10] = y & 0xFF;
-  writeCommand(cmd, CMD_DRAW_COMPASS_LEN);
-  free(cmd);
+  const uint32_t fields[] = {id, diameter, x, y};
+  sendFields(CMD_OF_DRAW_COMPASS, CMD_DRAW_COMPASS_LEN, compassLayout, fields);
 }
 
 void DFRobot_LcdDisplay::setCompassScale(uint8_t compassId, uint16_t scale)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_COMPASS_VALUE, CMD_SET_COMPASS_VALUE_LEN);
+  uint8_t cmd[CMD_SET_COMPASS_VALUE_LEN];
+  creatCommand(cmd, CMD_OF_DRAW_COMPASS_VALUE, CMD_SET_COMPASS_VALUE_LEN);
   cmd[4] = compassId;
   cmd[5] = scale >> 8;
   cmd[6] = scale & 0xFF;
 
-  writeCommand(cmd, CMD_SET_COMPASS_VALUE_LEN);
-  free(cmd);
+  sendCommand(cmd, CMD_SET_COMPASS_VALUE_LEN);
 }
 
 void DFRobot_LcdDisplay::deleteCompass(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
+  uint8_t cmd[CMD_DELETE_OBJ_LEN];
+  creatCommand(cmd, CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_COMPASS;
   cmd[5] = id;
-  writeCommand(cmd, CMD_DELETE_OBJ_LEN);
-  free(cmd);
-  deleteNodeByID((GenericNode**)&compass_head,id);
+  sendCommand(cmd, CMD_DELETE_OBJ_LEN);
+  freeID(CMD_OF_DRAW_COMPASS, id);
 }
+#endif
 
 void DFRobot_LcdDisplay::setBackgroundColor(uint32_t bg_color)
 {
-  uint8_t* cmd = creatCommand(CMD_SET_BACKGROUND_COLOR, CMD_SET_LEN);
+  uint8_t cmd[CMD_SET_LEN];
+  creatCommand(cmd, CMD_SET_BACKGROUND_COLOR, CMD_SET_LEN);
   cmd[4] = bg_color >> 16;
   cmd[5] = bg_color >> 8;
   cmd[6] = bg_color & 0xFF;
-  writeCommand(cmd, CMD_SET_LEN);
-  free(cmd);
-  delay(300);
+  sendCommand(cmd, CMD_SET_LEN, 300);
+}
+
+void DFRobot_LcdDisplay::setBackgroundImg(uint8_t location, String str)
+{
+  setBackgroundImg(location, str.c_str());
+}
+
+void DFRobot_LcdDisplay::setBackgroundImg(uint8_t location, const char* str)
+{
+  setBackgroundImg(location, str, strlen(str));
+}
+
+void DFRobot_LcdDisplay::setBackgroundImg(uint8_t location, const __FlashStringHelper* str)
+{
+  const sLcdText_t text = {(const char*)str, (uint16_t)strlen_P((const char*)str), true};
+  setBackgroundImg(location, text);
 }
 
-void DFRobot_LcdDisplay::setBackgroundImg(uint8_t location, String str){
-  const char* data = str.c_str();
-  uint8_t length = strlen(data);
-  uint8_t* cmd = creatCommand(CMD_SET_BACKGROUND_IMG, length + 5);
-  cmd[4] = location;
-  memcpy(cmd+5, data, length);
-  writeCommand(cmd, length + 5);
-  free(cmd);
+void DFRobot_LcdDisplay::setBackgroundImg(uint8_t location, const char* str, uint16_t len)
+{
+  const sLcdText_t text = {str, len, false};
+  setBackgroundImg(location, text);
+}
+
+void DFRobot_LcdDisplay::setBackgroundImg(uint8_t location, const sLcdText_t& text)
+{
+  const uint32_t fields[] = {location};
+  sendText(CMD_SET_BACKGROUND_IMG, backgroundLayout, fields, text);
 }
 
 
+#if !LCD_DISABLE_TEXT
 uint8_t DFRobot_LcdDisplay::drawString(uint16_t x, uint16_t y, String str, uint8_t fontSize, uint32_t color)
 {
-  const char* data = str.c_str();
-  uint8_t length = strlen(data);
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_TEXT, length + 13);
+  return drawString(x, y, str.c_str(), fontSize, color);
+}
+
+uint8_t DFRobot_LcdDisplay::drawString(uint16_t x, uint16_t y, const char* str, uint8_t fontSize, uint32_t color)
+{
+  return drawString(x, y, str, strlen(str), fontSize, color);
+}
+
+uint8_t DFRobot_LcdDisplay::drawString(uint16_t x, uint16_t y, const __FlashStringHelper* str, uint8_t fontSize, uint32_t color)
+{
+  const sLcdText_t text = {(const char*)str, (uint16_t)strlen_P((const char*)str), true};
+  return drawString(x, y, text, fontSize, color);
+}
+
+uint8_t DFRobot_LcdDisplay::drawString(uint16_t x, uint16_t y, const char* str, uint16_t len, uint8_t fontSize, uint32_t color)
+{
+  const sLcdText_t text = {str, len, false};
+  return drawString(x, y, text, fontSize, color);
+}
+
+uint8_t DFRobot_LcdDisplay::drawString(uint16_t x, uint16_t y, const sLcdText_t& text, uint8_t fontSize, uint32_t color)
+{
   uint8_t id = getID(CMD_OF_DRAW_TEXT);
-  cmd[4] = id;
-  cmd[5] = fontSize;
-  cmd[6] = color >> 16;
-  cmd[7] = color >> 8;
-  cmd[8] = color & 0xFF;
-  cmd[9] = x >> 8;
-  cmd[10] = x & 0xFF;
-  cmd[11] = y >> 8;
-  cmd[12] = y & 0xFF;
-  memcpy(cmd+13, data, length);
-  writeCommand(cmd, length + 13);
-  free(cmd);
+  if (id == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {id, fontSize, color, x, y};
+  sendText(CMD_OF_DRAW_TEXT, textLayout, fields, text);
   return id;
 }
 
 void DFRobot_LcdDisplay::updateString(uint8_t id, uint16_t x, uint16_t y, String str, uint8_t fontSize, uint32_t color)
 {
-  const char* data = str.c_str();
-  uint16_t length = strlen(data);
-  if(length > 242){
-    length = 242;
+  updateString(id, x, y, str.c_str(), fontSize, color);
+}
+
+void DFRobot_LcdDisplay::updateString(uint8_t id, uint16_t x, uint16_t y, const char* str, uint8_t fontSize, uint32_t color)
+{
+  updateString(id, x, y, str, strlen(str), fontSize, color);
+}
+
+void DFRobot_LcdDisplay::updateString(uint8_t id, uint16_t x, uint16_t y, const __FlashStringHelper* str, uint8_t fontSize, uint32_t color)
+{
+  const sLcdText_t text = {(const char*)str, (uint16_t)strlen_P((const char*)str), true};
+  updateString(id, x, y, text, fontSize, color);
+}
+
+void DFRobot_LcdDisplay::updateString(uint8_t id, uint16_t x, uint16_t y, const char* str, uint16_t len, uint8_t fontSize, uint32_t color)
+{
+  const sLcdText_t text = {str, len, false};
+  updateString(id, x, y, text, fontSize, color);
+}
+
+void DFRobot_LcdDisplay::updateString(uint8_t id, uint16_t x, uint16_t y, const sLcdText_t& text, uint8_t fontSize, uint32_t color)
+{
+  const uint32_t fields[] = {id, fontSize, color, x, y};
+  sendText(CMD_OF_DRAW_TEXT, textLayout, fields, text);
+}
+
+uint8_t DFRobot_LcdDisplay::drawStringf(uint16_t x, uint16_t y, uint8_t fontSize, uint32_t color, const char* format, ...)
+{
+  uint8_t id = getID(CMD_OF_DRAW_TEXT);
+  if (id == 0) {
+    return 0;
   }
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_TEXT, length + 13);
-  if(cmd != NULL){
-    cmd[4] = id;
-    cmd[5] = fontSize;
-    cmd[6] = color >> 16;
-    cmd[7] = color >> 8;
-    cmd[8] = color & 0xFF;
-    cmd[9] = x >> 8;
-    cmd[10] = x & 0xFF;
-    cmd[11] = y >> 8;
-    cmd[12] = y & 0xFF;
-    memcpy(cmd+13, data, length);
-    writeCommand(cmd, length + 13);
-    free(cmd);
+  const uint32_t fields[] = {id, fontSize, color, x, y};
+  va_list args;
+  va_start(args, format);
+  sendFormatted(CMD_OF_DRAW_TEXT, textLayout, fields, format, false, args);
+  va_end(args);
+  return id;
+}
+
+uint8_t DFRobot_LcdDisplay::drawStringf(uint16_t x, uint16_t y, uint8_t fontSize, uint32_t color, const __FlashStringHelper* format, ...)
+{
+  uint8_t id = getID(CMD_OF_DRAW_TEXT);
+  if (id == 0) {
+    return 0;
   }
+  const uint32_t fields[] = {id, fontSize, color, x, y};
+  va_list args;
+  va_start(args, format);
+  sendFormatted(CMD_OF_DRAW_TEXT, textLayout, fields, (const char*)format, true, args);
+  va_end(args);
+  return id;
+}
+
+void DFRobot_LcdDisplay::updateStringf(uint8_t id, uint16_t x, uint16_t y, uint8_t fontSize, uint32_t color, const char* format, ...)
+{
+  const uint32_t fields[] = {id, fontSize, color, x, y};
+  va_list args;
+  va_start(args, format);
+  sendFormatted(CMD_OF_DRAW_TEXT, textLayout, fields, format, false, args);
+  va_end(args);
+}
+
+void DFRobot_LcdDisplay::updateStringf(uint8_t id, uint16_t x, uint16_t y, uint8_t fontSize, uint32_t color, const __FlashStringHelper* format, ...)
+{
+  const uint32_t fields[] = {id, fontSize, color, x, y};
+  va_list args;
+  va_start(args, format);
+  sendFormatted(CMD_OF_DRAW_TEXT, textLayout, fields, (const char*)format, true, args);
+  va_end(args);
 }
 
 void DFRobot_LcdDisplay::deleteString(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
+  uint8_t cmd[CMD_DELETE_OBJ_LEN];
+  creatCommand(cmd, CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_TEXT;
   cmd[5] = id;
-  writeCommand(cmd, CMD_DELETE_OBJ_LEN);
-  free(cmd);
-  deleteNodeByID((GenericNode**)&text_head,id);
+  sendCommand(cmd, CMD_DELETE_OBJ_LEN);
+  freeID(CMD_OF_DRAW_TEXT, id);
 }
 
 uint8_t DFRobot_LcdDisplay::drawLcdTime(uint8_t x, uint8_t y, uint8_t hour, uint8_t Minute, uint8_t seconds, uint8_t fontSize, uint16_t color)
 {
-  String time1 = "";
-
-  if (hour < 10) {
-    time1 += "0";
-  }
-  time1 += String(hour);
-  time1 += ":";
-  if (Minute < 10) {
-    time1 += "0";
-  }
-  time1 += String(Minute);
-  time1 += ":";
-  if (seconds < 10) {
-    time1 += "0";
-  }
-  time1 += String(seconds);
-
-  return drawString(x, y, time1, fontSize, color);
+  char time[12];
+  uint16_t len = formatTime(time, hour, Minute, seconds);
+  return drawString(x, y, time, len, fontSize, color);
 }
 
 void DFRobot_LcdDisplay::updateLcdTime(uint8_t id, uint8_t x, uint8_t y, uint8_t hour, uint8_t Minute, uint8_t seconds, uint8_t fontSize, uint16_t color)
 {
-  String time1 = "";
-
-  if (hour < 10) {
-    time1 += "0";
-  }
-  time1 += String(hour);
-  time1 += ":";
-  if (Minute < 10) {
-    time1 += "0";
-  }
-  time1 += String(Minute);
-  time1 += ":";
-  if (seconds < 10) {
-    time1 += "0";
-  }
-  time1 += String(seconds);
-
-  updateString(id, x, y, time1, fontSize, color);
+  char time[12];
+  uint16_t len = formatTime(time, hour, Minute, seconds);
+  updateString(id, x, y, time, len, fontSize, color);
 }
 
 void DFRobot_LcdDisplay::drawLcdDate(uint8_t x, uint8_t y, uint8_t month, uint8_t day, uint8_t weeks, uint8_t fontSize, uint16_t color)
 {
-  String date = "";
-  if (month < 10) {
-    date += "0";
-  }
-  date += String(month);
-  date += "月";
-  if (day < 10) {
-    date += "0";
-  }
-  date += String(day);
-  date += "日 周";
-  if (weeks == 1) {
-    date += "一";
-  } else if (weeks == 2) {
-    date += "二";
-  } else if (weeks == 3) {
-    date += "三";
-  } else if (weeks == 4) {
-    date += "四";
-  } else if (weeks == 5) {
-    date += "五";
-  } else if (weeks == 6) {
-    date += "六";
-  } else if (weeks == 7) {
-    date += "日";
-  }
-  drawString(x, y, date, fontSize, color);
+  char date[24];
+  char* p = appendNumber(date, month);
+  p = appendText(p, "月");
+  p = appendNumber(p, day);
+  p = appendText(p, "日 周");
+  if ((weeks >= 1) && (weeks <= 7)) {
+    memcpy(p, &"一二三四五六日"[(weeks - 1) * 3], 3);   // 3 bytes per character in UTF-8
+    p += 3;
+  }
+  drawString(x, y, date, p - date, fontSize, color);
 }
+#endif
 
+#if !LCD_DISABLE_METER
 uint8_t DFRobot_LcdDisplay::creatLineMeter(uint16_t x, uint16_t y, uint16_t size, uint16_t start, uint16_t end, uint32_t pointerColor, uint32_t bgColor)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_LINE_METER, CMD_OF_DRAW_LINE_METER_LEN);
   uint8_t id = getID(CMD_OF_DRAW_LINE_METER);
-  cmd[4] = id;
-  cmd[5] = size >> 8;
-  cmd[6] = size & 0xFF;
-  cmd[7] = start >> 8;
-  cmd[8] = start & 0xFF;
-  cmd[9] = end >> 8;
-  cmd[10] = end & 0xFF;
-  cmd[11] = pointerColor >> 16;
-  cmd[12] = pointerColor >> 8;
-  cmd[13] = pointerColor & 0xFF;
-  cmd[14] = bgColor >> 16;
-  cmd[15] = bgColor >> 8;
-  cmd[16] = bgColor & 0xFF;
-  cmd[17] = x >> 8;
-  cmd[18] = x & 0xFF;
-  cmd[19] = y >> 8;
-  cmd[20] = y & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_LINE_METER_LEN);
-  free(cmd);
+  if (id == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {id, size, start, end, pointerColor, bgColor, x, y};
+  sendFields(CMD_OF_DRAW_LINE_METER, CMD_OF_DRAW_LINE_METER_LEN, meterLayout, fields);
   return id;
 }
 
 void DFRobot_LcdDisplay::updateLineMeter(uint8_t id, uint16_t x, uint16_t y, uint16_t size, uint16_t start, uint16_t end, uint32_t pointerColor, uint32_t bgColor)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_LINE_METER, CMD_OF_DRAW_LINE_METER_LEN);
-  cmd[4] = id;
-  cmd[5] = size >> 8;
-  cmd[6] = size & 0xFF;
-  cmd[7] = start >> 8;
-  cmd[8] = start & 0xFF;
-  cmd[9] = end >> 8;
-  cmd[10] = end & 0xFF;
-  cmd[11] = pointerColor >> 16;
-  cmd[12] = pointerColor >> 8;
-  cmd[13] = pointerColor & 0xFF;
-  cmd[14] = bgColor >> 16;
-  cmd[15] = bgColor >> 8;
-  cmd[16] = bgColor & 0xFF;
-  cmd[17] = x >> 8;
-  cmd[18] = x & 0xFF;
-  cmd[19] = y >> 8;
-  cmd[20] = y & 0xFF;
-  writeCommand(cmd, CMD_OF_DRAW_LINE_METER_LEN);
-  free(cmd);
+  const uint32_t fields[] = {id, size, start, end, pointerColor, bgColor, x, y};
+  sendFields(CMD_OF_DRAW_LINE_METER, CMD_OF_DRAW_LINE_METER_LEN, meterLayout, fields);
 }
 
 void DFRobot_LcdDisplay::deleteLineMeter(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
+  uint8_t cmd[CMD_DELETE_OBJ_LEN];
+  creatCommand(cmd, CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_LINE_METER;
   cmd[5] = id;
-  writeCommand(cmd, CMD_DELETE_OBJ_LEN);
-  free(cmd);
-  deleteNodeByID((GenericNode**)&lineMeter_head,id);
+  sendCommand(cmd, CMD_DELETE_OBJ_LEN);
+  freeID(CMD_OF_DRAW_LINE_METER, id);
 }
 
 void DFRobot_LcdDisplay::setTopLineMeter(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_SET_TOP_OBJ, CMD_SET_TOP_OBJ_LEN);
+  uint8_t cmd[CMD_SET_TOP_OBJ_LEN];
+  creatCommand(cmd, CMD_SET_TOP_OBJ, CMD_SET_TOP_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_LINE_METER;
   cmd[5] = id;
-  writeCommand(cmd, CMD_DELETE_OBJ_LEN);
-  free(cmd);
+  sendCommand(cmd, CMD_DELETE_OBJ_LEN);
 }
+#endif
 
+#if !LCD_DISABLE_CHART
 uint8_t DFRobot_LcdDisplay::creatChart(String strX, String strY, uint32_t bgColor, uint8_t type)
 {
-  uint8_t * creatCmd = creatCommand(CMD_OF_DRAW_LINE_CHART, CMD_DRAW_CHART_LEN);
+  const sLcdText_t textX = {strX.c_str(), (uint16_t)strX.length(), false};
+  const sLcdText_t textY = {strY.c_str(), (uint16_t)strY.length(), false};
+  return creatChart(textX, textY, bgColor, type);
+}
+
+uint8_t DFRobot_LcdDisplay::creatChart(const char* strX, const char* strY, uint32_t bgColor, uint8_t type)
+{
+  return creatChart(strX, strlen(strX), strY, strlen(strY), bgColor, type);
+}
+
+uint8_t DFRobot_LcdDisplay::creatChart(const __FlashStringHelper* strX, const __FlashStringHelper* strY, uint32_t bgColor, uint8_t type)
+{
+  const sLcdText_t textX = {(const char*)strX, (uint16_t)strlen_P((const char*)strX), true};
+  const sLcdText_t textY = {(const char*)strY, (uint16_t)strlen_P((const char*)strY), true};
+  return creatChart(textX, textY, bgColor, type);
+}
+
+uint8_t DFRobot_LcdDisplay::creatChart(const char* strX, uint16_t lenX, const char* strY, uint16_t lenY, uint32_t bgColor, uint8_t type)
+{
+  const sLcdText_t textX = {strX, lenX, false};
+  const sLcdText_t textY = {strY, lenY, false};
+  return creatChart(textX, textY, bgColor, type);
+}
+
+uint8_t DFRobot_LcdDisplay::creatChart(const sLcdText_t& textX, const sLcdText_t& textY, uint32_t bgColor, uint8_t type)
+{
   uint8_t id = getID(CMD_OF_DRAW_LINE_CHART);
-  creatCmd[4] = id;
-  creatCmd[5] = type;
-  creatCmd[6] = bgColor >> 16;
-  creatCmd[7] = bgColor >> 8;
-  creatCmd[8] = bgColor;
-  writeCommand(creatCmd, CMD_DRAW_CHART_LEN);
-  free(creatCmd);
-  delay(100);
-  setChartAxisTexts(id, 0, strX);
-  delay(100);
-  setChartAxisTexts(id, 1, strY);
+  if (id == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {id, type, bgColor};
+  sendFields(CMD_OF_DRAW_LINE_CHART, CMD_DRAW_CHART_LEN, chartLayout, fields, 100);
+  setChartAxisTexts(id, 0, textX, 100);
+  setChartAxisTexts(id, 1, textY);
   return id;
 }
 
 void DFRobot_LcdDisplay::updateChart(uint8_t id, uint32_t bgColor, uint8_t type)
 {
-  uint8_t * creatCmd = creatCommand(CMD_OF_DRAW_LINE_CHART, CMD_DRAW_CHART_LEN);
-  creatCmd[4] = id;
-  creatCmd[5] = type;
-  creatCmd[6] = bgColor >> 16;
-  creatCmd[7] = bgColor >> 8;
-  creatCmd[8] = bgColor;
-  writeCommand(creatCmd, CMD_DRAW_CHART_LEN);
-  free(creatCmd);
+  const uint32_t fields[] = {id, type, bgColor};
+  sendFields(CMD_OF_DRAW_LINE_CHART, CMD_DRAW_CHART_LEN, chartLayout, fields);
 }
 
 uint8_t DFRobot_LcdDisplay::creatChartSeries(uint8_t chartId, uint32_t color)
 {
-
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_SERIE, CMD_DRAW_SERIE_LEN);
   uint8_t serieId = getID(CMD_OF_DRAW_SERIE);
-  cmd[4] = serieId;
-  cmd[5] = chartId;   
-  cmd[6] = color >> 16;
-  cmd[7] = color >> 8;
-  cmd[8] = color ;
-  writeCommand(cmd, CMD_DRAW_SERIE_LEN);
-  free(cmd);
+  if (serieId == 0) {
+    return 0;
+  }
+  const uint32_t fields[] = {serieId, chartId, color};
+  sendFields(CMD_OF_DRAW_SERIE, CMD_DRAW_SERIE_LEN, seriesLayout, fields);
   return serieId;
 }
 
 void DFRobot_LcdDisplay::updateChartSeries(uint8_t chartId, uint8_t seriesId, uint32_t color){
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_SERIE, CMD_DRAW_SERIE_LEN);
-  cmd[4] = seriesId;
-  cmd[5] = chartId;   
-  cmd[6] = color >> 16;
-  cmd[7] = color >> 8;
-  cmd[8] = color ;
-  writeCommand(cmd, CMD_DRAW_SERIE_LEN);
-  free(cmd);
+  const uint32_t fields[] = {seriesId, chartId, color};
+  sendFields(CMD_OF_DRAW_SERIE, CMD_DRAW_SERIE_LEN, seriesLayout, fields);
 }
 
-uint8_t DFRobot_LcdDisplay::setChartAxisTexts(uint8_t chartId, uint8_t axis, String text)
+uint8_t DFRobot_LcdDisplay::setChartAxisTexts(uint8_t chartId, uint8_t axis, const sLcdText_t& text, uint16_t settle)
 {
-  uint8_t textLen = text.length();
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_LINE_CHART_TEXT, textLen + 6);
-  cmd[4] = chartId;
-  cmd[5] = axis;
-  for (uint8_t i = 0;i < textLen;i++) {
-    cmd[6 + i] = text[i];
-  }
-  writeCommand(cmd, textLen + 6);
-  free(cmd);
+  const uint32_t fields[] = {chartId, axis};
+  sendText(CMD_OF_DRAW_LINE_CHART_TEXT, axisLayout, fields, text, settle);
   return 1;
 }
 
 
 void DFRobot_LcdDisplay::updateChartPoint(uint8_t chartId, uint8_t SeriesId, uint8_t pointNum, uint16_t value){
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_SERIE_DATA, 10);
-  cmd[4] = chartId;
-  cmd[5] = SeriesId;
-  cmd[6] = 1;
-  cmd[7] = pointNum;
-  cmd[8] = value >> 8;
-  cmd[9] = value & 0xFF;
-  writeCommand(cmd,  10);
-  free(cmd);
+  const uint32_t fields[] = {chartId, SeriesId, 1, pointNum, value};
+  sendFields(CMD_OF_DRAW_SERIE_DATA, CMD_DRAW_SERIE_POINT_LEN, pointLayout, fields);
 }
 
 uint8_t DFRobot_LcdDisplay::addChartSeriesData(uint8_t chartId, uint8_t SeriesId, uint16_t point[], uint8_t len)
 {
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_SERIE_DATA, len*2 + 8);
+  if (len > (LCD_FRAME_MAX_LEN - 8) / 2) {
+    len = (LCD_FRAME_MAX_LEN - 8) / 2;
+  }
+  uint8_t cmd[LCD_FRAME_MAX_LEN];
+  creatCommand(cmd, CMD_OF_DRAW_SERIE_DATA, len*2 + 8);
   cmd[4] = chartId;
   cmd[5] = SeriesId;
   cmd[6] = 0;
@@ -1108,146 +925,1434 @@ uint8_t DFRobot_LcdDisplay::addChartSeriesData(uint8_t chartId, uint8_t SeriesId
     cmd[8 + 2*i]     = point[i]>>8;
     cmd[8 + 2*i + 1] = point[i];
   }
-  writeCommand(cmd,  len*2 + 8);
-  free(cmd);
+  sendCommand(cmd,  len*2 + 8);
   return 1;
 }
 
 void DFRobot_LcdDisplay::setTopChart(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_SET_TOP_OBJ, CMD_SET_TOP_OBJ_LEN);
+  uint8_t cmd[CMD_SET_TOP_OBJ_LEN];
+  creatCommand(cmd, CMD_SET_TOP_OBJ, CMD_SET_TOP_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_LINE_CHART;
   cmd[5] = id;
-  writeCommand(cmd, CMD_SET_TOP_OBJ_LEN);
-  free(cmd);
+  sendCommand(cmd, CMD_SET_TOP_OBJ_LEN);
 }
 
 void DFRobot_LcdDisplay::deleteChart(uint8_t id){
-  uint8_t* cmd = creatCommand(CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
+  uint8_t cmd[CMD_DELETE_OBJ_LEN];
+  creatCommand(cmd, CMD_DELETE_OBJ, CMD_DELETE_OBJ_LEN);
   cmd[4] = CMD_OF_DRAW_LINE_CHART;
   cmd[5] = id;
-  writeCommand(cmd, CMD_DELETE_OBJ_LEN);
-  free(cmd);
-  deleteNodeByID((GenericNode**)&line_chart_head,id);
+  sendCommand(cmd, CMD_DELETE_OBJ_LEN);
+  freeID(CMD_OF_DRAW_LINE_CHART, id);
 }
+#endif
 
+#if !LCD_DISABLE_METER
 void DFRobot_LcdDisplay::setMeterValue(uint8_t lineMeterId, uint16_t value)
 {
 
-  uint8_t* cmd = creatCommand(CMD_OF_DRAW_LINE_METER_VALUE, CMD_SET_LINE_METER_VALUE_LEN);
+  uint8_t cmd[CMD_SET_LINE_METER_VALUE_LEN];
+  creatCommand(cmd, CMD_OF_DRAW_LINE_METER_VALUE, CMD_SET_LINE_METER_VALUE_LEN);
   cmd[4] = lineMeterId;
   cmd[5] = value >> 8;
   cmd[6] = value & 0xFF;
-  writeCommand(cmd, CMD_SET_LINE_METER_VALUE_LEN);
-  free(cmd);
+  sendCommand(cmd, CMD_SET_LINE_METER_VALUE_LEN);
 }
+#endif
 
 
-uint8_t* DFRobot_LcdDisplay::creatCommand(uint8_t cmd, uint8_t len)
+void DFRobot_LcdDisplay::creatCommand(uint8_t* pBuf, uint8_t cmd, uint8_t len)
 {
-  uint8_t* data = (uint8_t*)malloc(sizeof(uint8_t) * len);
-  if (data == NULL) {
-    DBG("malloc FAIL");
-    return NULL;
-  }
-  data[0] = CMD_HEADER_HIGH;
-  data[1] = CMD_HEADER_LOW;
-  data[2] = len - CMDLEN_OF_HEAD_LEN;
-  data[3] = cmd;
-  return data;
+  memset(pBuf, 0, len);
+  pBuf[0] = CMD_HEADER_HIGH;
+  pBuf[1] = CMD_HEADER_LOW;
+  pBuf[2] = len - CMDLEN_OF_HEAD_LEN;
+  pBuf[3] = cmd;
 }
 
-DFRobot_Lcd_IIC::DFRobot_Lcd_IIC(TwoWire* pWire, uint8_t addr)
+void DFRobot_LcdDisplay::packFields(uint8_t* pBuf, uint32_t layout, const uint32_t* fields)
 {
-  _deviceAddr = addr;
-  _pWire = pWire;
-
+  uint8_t pos = 4;
+  for (; layout; layout >>= 2, fields++) {
+    for (uint8_t shift = (layout & 3) * 8; shift; ) {
+      shift -= 8;
+      pBuf[pos++] = *fields >> shift;
+    }
+  }
 }
 
-bool DFRobot_Lcd_IIC::begin()
+void DFRobot_LcdDisplay::sendFields(uint8_t cmd, uint8_t len, uint32_t layout, const uint32_t* fields, uint16_t settle)
 {
-  _pWire->begin();
-  if (_pWire == NULL) return false;
-  _pWire->begin();
-  _pWire->setClock(100000);
-  _pWire->beginTransmission(_deviceAddr);
-  if (_pWire->endTransmission() != 0) return false;
-
-  return true;
+  uint8_t frame[LCD_FIELDS_FRAME_MAX_LEN];
+  creatCommand(frame, cmd, len);
+  packFields(frame, layout, fields);
+  sendCommand(frame, len, settle);
 }
 
-void DFRobot_Lcd_IIC::writeCommand(uint8_t* pBuf, uint16_t len)
+void DFRobot_LcdDisplay::sendText(uint8_t cmd, uint32_t layout, const uint32_t* fields, const sLcdText_t& text, uint16_t settle)
 {
-  uint16_t bytesSent = 0; // The number of bytes sent
-  uint16_t bytesToSend = len; // The number of bytes to be sent
-  if (pBuf == NULL) {
-    DBG("pBuf ERROR!! : null pointer");
+  uint8_t head[LCD_TEXT_HEAD_MAX_LEN];
+  uint8_t headLen = CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(layout);
+  uint16_t len = text.len;
+  if (len > LCD_FRAME_MAX_LEN - headLen) {
+    len = LCD_FRAME_MAX_LEN - headLen;
   }
-
-  while (bytesToSend > 0) {
-    uint16_t currentTransferSize = (bytesToSend < 32) ? bytesToSend : 32;
-    
-    _pWire->beginTransmission(_deviceAddr);
-    
-    _pWire->write(&pBuf[bytesSent], currentTransferSize);
-    
-    _pWire->endTransmission();
-    
-    bytesSent += currentTransferSize;
-    bytesToSend -= currentTransferSize;
-
-    delay(50);
+  creatCommand(head, cmd, headLen);
+  head[2] += len;
+  packFields(head, layout, fields);
+  if (!text.flash && !_batching && !_async && !_shadowing) {
+    transmitGather(head, headLen, (const uint8_t*)text.str, len, settle);
+    return;
   }
+  sendJoined(head, headLen, text, len, settle);
 }
 
-void DFRobot_Lcd_IIC::readACK(uint8_t* pBuf, uint16_t len)
+void DFRobot_LcdDisplay::sendFormatted(uint8_t cmd, uint32_t layout, const uint32_t* fields, const char* format, bool flash, va_list args)
 {
-  if (pBuf == NULL) {
-    DBG("pBuf ERROR!! : null pointer");
+  uint8_t frame[LCD_FRAME_MAX_LEN + 1];   // + the terminating NUL of vsnprintf()
+  uint8_t headLen = CMDLEN_OF_HEAD_LEN + 1 + lcdLayoutLen(layout);
+  char* text = (char*)frame + headLen;
+  uint16_t size = LCD_FRAME_MAX_LEN - headLen + 1;
+  int len = flash ? vsnprintf_P(text, size, format, args) : vsnprintf(text, size, format, args);
+  if (len < 0) {
+    len = 0;
+  } else if (len > LCD_FRAME_MAX_LEN - headLen) {
+    len = LCD_FRAME_MAX_LEN - headLen;
   }
-  uint8_t* _pBuf = (uint8_t*)pBuf;
-  _pWire->requestFrom(_deviceAddr, (uint8_t)len);
-  for (uint16_t i = 0; i < len; i++) {
+  creatCommand(frame, cmd, headLen);
+  frame[2] += len;
+  packFields(frame, layout, fields);
+  sendCommand(frame, headLen + len);
+}
 
-    _pBuf[i] = _pWire->read();
+void DFRobot_LcdDisplay::sendJoined(const uint8_t* head, uint8_t headLen, const sLcdText_t& text, uint16_t len, uint16_t settle)
+{
+  uint8_t frame[LCD_FRAME_MAX_LEN];
+  memcpy(frame, head, headLen);
+  if (text.flash) {
+    memcpy_P(frame + headLen, text.str, len);
+  } else {
+    memcpy(frame + headLen, text.str, len);
   }
+  sendCommand(frame, headLen + len, settle);
+}
 
+#if !LCD_DISABLE_BATCH
+void DFRobot_LcdDisplay::beginBatch()
+{
+  _batching = true;
 }
 
-DFRobot_Lcd_UART::DFRobot_Lcd_UART(Stream& s)
+void DFRobot_LcdDisplay::endBatch()
 {
-  _s = &s;
+  flush();
+  _batching = false;
 }
 
-bool DFRobot_Lcd_UART::begin()
+void DFRobot_LcdDisplay::flush()
 {
-  // warning: the compiler can assume that the address of 's' will never be NULL
-  if (_s == NULL) {
-    return false;
+  if (_batchLen == 0) {
+    return;
   }
-  return true;
+  transmit(_batchBuf, _batchLen, 0);
+  _batchLen = 0;
 }
+#endif
 
-void DFRobot_Lcd_UART::writeCommand(uint8_t* pBuf, uint16_t len)
+void DFRobot_LcdDisplay::sendCommand(uint8_t* pBuf, uint16_t len, uint16_t settle)
 {
-  uint8_t* _pBuf = (uint8_t*)pBuf;
-  _s->write((uint8_t*)_pBuf, len);
-  delay(50);
+#if !LCD_DISABLE_SHADOW
+  if (_shadowing && shadowHit(pBuf, len)) {
+    return;
+  }
+#endif
+  if (!_batching) {
+    transmit(pBuf, len, settle);
+    return;
+  }
+#if !LCD_DISABLE_BATCH
+  if (_batchLen + len > LCD_BATCH_BUF_LEN) {
+    flush();
+  }
+  if (len > LCD_BATCH_BUF_LEN) {
+    // Larger than the whole batch buffer, send it on its own
+    transmit(pBuf, len, settle);
+    return;
+  }
+  if (isValueCommand(pBuf[3]) && coalesceBatch(pBuf, len)) {
+    return;
+  }
+  memcpy(_batchBuf + _batchLen, pBuf, len);
+  _batchLen += len;
+  if (settle) {
+    // The screen needs time after this frame, so it cannot wait for the rest of the batch
+    transmit(_batchBuf, _batchLen, settle);
+    _batchLen = 0;
+  }
+#endif
 }
 
-void DFRobot_Lcd_UART::readACK(uint8_t* pBuf, uint16_t len)
+void DFRobot_LcdDisplay::transmit(uint8_t* pBuf, uint16_t len, uint16_t settle)
 {
-  LCD_UNUSED(pBuf);
-  LCD_UNUSED(len);
-
-  long long current = millis();
+  LCD_STAT(unsigned long start = micros());
+  if (!_async) {
+    sLcdWriteEvent_t event;
+    bool hooked = (_preWrite != NULL) || (_postWrite != NULL);
+    if (hooked) {
+      preWrite(&event, pBuf, len);
+    }
+    writeCommand(pBuf, len);
+    if (settle) {
+      delay(settle);
+    }
+    if (hooked) {
+      postWrite(&event);
+    }
+    LCD_STAT(statFrames(pBuf, len));
+    LCD_STAT(statBlocked(micros() - start));
+    return;
+  }
+#if !LCD_DISABLE_ASYNC
+  // pBuf may hold several frames (a flushed batch), queue them one by one
+  uint16_t offset = 0;
+  while (offset < len) {
+    uint16_t frameLen = pBuf[offset + 2] + CMDLEN_OF_HEAD_LEN;
+    bool last = (offset + frameLen >= len);
+    enqueueCommand(pBuf + offset, frameLen, last ? settle : 0);
+    offset += frameLen;
+  }
+  LCD_STAT(statBlocked(micros() - start));
+#endif
+}
 
-  while (true) {
+void DFRobot_LcdDisplay::transmitGather(const uint8_t* head, uint8_t headLen, const uint8_t* payload, uint16_t payloadLen, uint16_t settle)
+{
+  LCD_STAT(unsigned long start = micros());
+  sLcdWriteEvent_t event;
+  bool hooked = (_preWrite != NULL) || (_postWrite != NULL);
+  if (hooked) {
+    preWrite(&event, head, headLen + payloadLen);
+  }
+  writeGather(head, headLen, payload, payloadLen);
+  if (settle) {
+    delay(settle);
+  }
+  if (hooked) {
+    postWrite(&event);
+  }
+  LCD_STAT(statFrame(head[3]));
+  LCD_STAT(statBlocked(micros() - start));
+}
 
-    if (_s->available()) {
-      uint8_t data = _s->read();
-      LCD_UNUSED(data);
+void DFRobot_LcdDisplay::writeGather(const uint8_t* head, uint16_t headLen, const uint8_t* payload, uint16_t payloadLen)
+{
+  uint16_t len = headLen + payloadLen;
+  uint16_t bytesSent = 0;
+  while (bytesSent < len) {
+    uint16_t sent;
+    if (bytesSent < headLen) {
+      sent = _writeFn(this, &head[bytesSent], headLen - bytesSent, payload, payloadLen);
+    } else {
+      sent = _writeFn(this, &payload[bytesSent - headLen], len - bytesSent, NULL, 0);
+    }
+    if (sent == 0) {
+      // The interface failed, drop the rest of the frame instead of retrying forever
+      break;
     }
-    if ((millis() - current) > 1000) break;
+    bytesSent += sent;
+    waitReady();
+  }
+}
+
+#if !LCD_DISABLE_ASYNC
+void DFRobot_LcdDisplay::setAsync(bool enable, sLcdQueuePolicy_t policy)
+{
+  if (!enable) {
+#if !LCD_DISABLE_BATCH
+    flush();
+#endif
+    drainQueue();
+  }
+  _async = enable;
+  _queuePolicy = policy;
+}
+
+uint16_t DFRobot_LcdDisplay::queueDepth()
+{
+  return _txQueue.frames + _liveQueue.frames;
+}
+
+void DFRobot_LcdDisplay::setDeadline(uint16_t ms)
+{
+  _deadline = ms;
+}
+
+uint32_t DFRobot_LcdDisplay::getDroppedCount()
+{
+  return _txDropped;
+}
+#endif
+
+uint32_t DFRobot_LcdDisplay::getCoalescedCount()
+{
+  return _coalesced;
+}
+
+#if !LCD_DISABLE_SHADOW
+void DFRobot_LcdDisplay::setShadowCache(bool enable)
+{
+  _shadowing = enable;
+  memset(_shadow, 0, sizeof(_shadow));
+  _shadowNext = 0;
+}
+
+uint32_t DFRobot_LcdDisplay::getShadowHits()
+{
+  return _shadowHits;
+}
+
+uint32_t DFRobot_LcdDisplay::getShadowMisses()
+{
+  return _shadowMisses;
+}
+#endif
+
+uint32_t DFRobot_LcdDisplay::replay(Stream& trace, bool realTime)
+{
+  uint8_t frame[LCD_FRAME_MAX_LEN + CMDLEN_OF_HEAD_LEN];
+  uint8_t stamp[LCD_TRACE_STAMP_LEN];
+  uint32_t first = 0;
+  unsigned long start = 0;
+  uint32_t frames = 0;
+
+  // Whatever is still pending belongs before the replayed frames
+#if !LCD_DISABLE_BATCH
+  flush();
+#endif
+#if !LCD_DISABLE_ASYNC
+  drainQueue();
+#endif
+
+  uint16_t got;
+  while ((got = trace.readBytes((char*)stamp, LCD_TRACE_STAMP_LEN)) != 0) {
+    // A record is only complete with its timestamp, a frame header and as many bytes as the header says
+    if ((got != LCD_TRACE_STAMP_LEN) ||
+        (trace.readBytes((char*)frame, CMDLEN_OF_HEAD_LEN) != CMDLEN_OF_HEAD_LEN) ||
+        (frame[0] != CMD_HEADER_HIGH) || (frame[1] != CMD_HEADER_LOW) || (frame[2] == 0) ||
+        (trace.readBytes((char*)frame + CMDLEN_OF_HEAD_LEN, frame[2]) != frame[2])) {
+      _lastError = eLcdBadTrace;
+      break;
+    }
+
+    uint32_t t = 0;
+    for (uint8_t b = 0; b < LCD_TRACE_STAMP_LEN; b++) {
+      t |= (uint32_t)stamp[b] << (8 * b);
+    }
+    if (frames == 0) {
+      first = t;
+      start = micros();
+    } else if (realTime) {
+      while ((uint32_t)(micros() - start) < (uint32_t)(t - first)) {
+        yield();
+      }
+    }
+    writeCommand(frame, frame[2] + CMDLEN_OF_HEAD_LEN);
+    LCD_STAT(statFrame(frame[3]));
+    frames++;
+  }
+  return frames;
+}
+
+DFRobot_LcdDisplay::sLcdError_t DFRobot_LcdDisplay::getLastError()
+{
+  sLcdError_t error = _lastError;
+  _lastError = eLcdOK;
+  return error;
+}
+
+void DFRobot_LcdDisplay::setWriteHooks(sLcdWriteHook_t pre, sLcdWriteHook_t post)
+{
+  _preWrite = pre;
+  _postWrite = post;
+}
+
+void DFRobot_LcdDisplay::setCallSite(const char* file, uint16_t line)
+{
+  _callFile = file;
+  _callLine = line;
+}
+
+void DFRobot_LcdDisplay::preWrite(sLcdWriteEvent_t* event, const uint8_t* pBuf, uint16_t len)
+{
+  uint8_t cmd = pBuf[3];
+  event->cmd = cmd;
+  switch (frameKeyLen(cmd)) {
+    case 0:
+    case 1:
+      event->id = 0;
+      break;
+    case 3:
+      // Delete, raise and rotate name the object type first; chart texts the chart
+      event->id = (cmd == CMD_OF_DRAW_LINE_CHART_TEXT) ? pBuf[4] : pBuf[5];
+      break;
+    default:
+      event->id = pBuf[4];
+      break;
+  }
+  event->len = len;
+  event->file = _callFile;
+  event->line = _callLine;
+  event->end = 0;
+  event->start = micros();
+  if (_preWrite != NULL) {
+    _preWrite(event);
+  }
+}
+
+void DFRobot_LcdDisplay::postWrite(sLcdWriteEvent_t* event)
+{
+  event->end = micros();
+  if (_postWrite != NULL) {
+    _postWrite(event);
+  }
+}
+
+#if LCD_ENABLE_STATS
+void DFRobot_LcdDisplay::resetStats()
+{
+  memset(&_stats, 0, sizeof(_stats));
+}
+
+void DFRobot_LcdDisplay::statFrame(uint8_t cmd)
+{
+  if (cmd < LCD_CMD_NUM) {
+    _stats.frames[cmd]++;
+  }
+}
+
+void DFRobot_LcdDisplay::statFrames(const uint8_t* pBuf, uint16_t len)
+{
+  uint16_t offset = 0;
+  while (offset + CMDLEN_OF_HEAD_LEN < len) {
+    statFrame(pBuf[offset + 3]);
+    offset += pBuf[offset + 2] + CMDLEN_OF_HEAD_LEN;
+  }
+}
+
+void DFRobot_LcdDisplay::statBlocked(unsigned long us)
+{
+  _stats.blockedUs += us;
+  if (us > _stats.maxBlockedUs) {
+    _stats.maxBlockedUs = us;
+  }
+}
+#endif
+
+#if !LCD_DISABLE_SHADOW
+bool DFRobot_LcdDisplay::shadowHit(uint8_t* pBuf, uint16_t len)
+{
+  uint8_t cmd = pBuf[3];
+  switch (cmd) {
+    case 0x1D:
+      memset(_shadow, 0, sizeof(_shadow));
+      return false;
+    case CMD_DELETE_OBJ:
+      shadowForget(pBuf);
+      return false;
+    case CMD_OF_DRAW_PIXEL:
+    case CMD_SET_TOP_OBJ:             // depends on what was drawn since
+    case CMD_SET_BACKGROUND_COLOR:
+    case CMD_SET_BACKGROUND_IMG:
+    case CMD_OF_DRAW_LINE_CHART:      // series IDs outlive their chart, keep charts out of the cache
+    case CMD_OF_DRAW_LINE_CHART_TEXT:
+    case CMD_OF_DRAW_SERIE:
+    case CMD_OF_DRAW_SERIE_DATA:
+      return false;
+    default:
+      break;
+  }
+
+  // An icon drawn from a path and the same icon drawn from the built-in set share one entry
+  uint8_t keyLen = frameKeyLen(cmd);
+  uint8_t key[sizeof(_shadow[0].key)] = {0};
+  memcpy(key, pBuf + 3, keyLen);
+  key[0] = objectType(cmd);
+  uint32_t hash = 2166136261UL;
+  for (uint16_t i = 0; i < len; i++) {
+    hash = (hash ^ pBuf[i]) * 16777619UL;
+  }
+
+  sShadowEntry_t* entry = NULL;
+  for (uint8_t i = 0; i < LCD_SHADOW_CACHE_LEN; i++) {
+    if (_shadow[i].key[0] && (memcmp(_shadow[i].key, key, keyLen) == 0)) {
+      entry = &_shadow[i];
+      break;
+    }
+  }
+  if ((entry != NULL) && (entry->hash == hash)) {
+    _shadowHits++;
+    return true;
+  }
+  _shadowMisses++;
+  if (entry == NULL) {
+    entry = &_shadow[_shadowNext];
+    _shadowNext = (_shadowNext + 1) % LCD_SHADOW_CACHE_LEN;
+    memcpy(entry->key, key, sizeof(entry->key));
+  }
+  entry->hash = hash;
+  return false;
+}
+
+void DFRobot_LcdDisplay::shadowForget(uint8_t* pBuf)
+{
+  uint8_t keyLen = frameKeyLen(pBuf[3]);
+  uint8_t frameKey[sizeof(_shadow[0].key)] = {0};
+  memcpy(frameKey, pBuf + 3, keyLen);
+  frameKey[0] = objectType(pBuf[3]);
+  for (uint8_t i = 0; i < LCD_SHADOW_CACHE_LEN; i++) {
+    uint8_t* key = _shadow[i].key;
+    bool forget;
+    if (pBuf[3] == CMD_DELETE_OBJ) {
+      // Entries do not record the object type, so forget every object with this ID
+      forget = (key[1] == pBuf[5]) || ((key[0] == CMD_SET_ANGLE_OBJ) && (key[2] == pBuf[5]));
+    } else {
+      forget = (memcmp(key, frameKey, keyLen) == 0);
+    }
+    if (forget) {
+      key[0] = 0;
+    }
+  }
+}
+#endif
+
+#if !LCD_DISABLE_ASYNC
+void DFRobot_LcdDisplay::poll()
+{
+  LCD_STAT(unsigned long start = micros());
+  sendQueued();
+  LCD_STAT(statBlocked(micros() - start));
+}
+
+void DFRobot_LcdDisplay::sendQueued()
+{
+  if ((_txQueue.frames == 0) && (_liveQueue.frames == 0)) {
+    return;
+  }
+  if ((long)(millis() - _txReadyAt) < 0) {
+    // Still inside the settle time of the last write, unless the module already acknowledged it
+    if (!_txAckWait || !pollACK()) {
+      return;
+    }
+  }
+
+  // Live values go first, but never cut into a layout frame that is partly on the wire
+  sLcdQueue_t* queue = &_liveQueue;
+  if ((_liveQueue.frames == 0) || (_txQueue.offset != 0)) {
+    queue = &_txQueue;
+    dropExpired();
+    if (_txQueue.frames == 0) {
+      return;
+    }
+  }
+
+  uint8_t chunk[LCD_ASYNC_CHUNK_LEN];
+  uint16_t len = peekQueue(queue, chunk, LCD_ASYNC_CHUNK_LEN);
+  sLcdWriteEvent_t event;
+  bool hooked = (_preWrite != NULL) || (_postWrite != NULL);
+  if (hooked) {
+    // The chunk may start inside a frame, take command and ID from the queued frame itself
+    uint8_t head[6];
+    for (uint8_t i = 0; i < sizeof(head); i++) {
+      head[i] = queue->buf[ringIndex(queue, queue->tail + LCD_QUEUE_ENTRY_HEAD + i)];
+    }
+    preWrite(&event, head, len);
+  }
+  uint16_t sent = writeChunk(chunk, len);
+  if (hooked) {
+    event.len = sent;
+    postWrite(&event);
+  }
+  uint8_t settle = consumeQueue(queue, sent);
+
+  _txReadyAt = millis() + (_flowControl ? _ackTimeout : LCD_SETTLE_TIME_MS) + settle * 10UL;
+  _txAckWait = _flowControl && (settle == 0);
+}
+
+void DFRobot_LcdDisplay::drainQueue()
+{
+  while (_txQueue.frames || _liveQueue.frames) {
+    sendQueued();
+    yield();
+  }
+}
+
+uint16_t DFRobot_LcdDisplay::ringIndex(sLcdQueue_t* queue, uint16_t pos)
+{
+  return (pos >= queue->size) ? (pos - queue->size) : pos;
+}
+#endif
+
+uint8_t DFRobot_LcdDisplay::frameKeyLen(uint8_t cmd)
+{
+  switch (cmd) {
+    case CMD_OF_DRAW_PIXEL:
+    case CMD_OF_DRAW_SERIE_DATA:
+      return 0;   // no object identity, never merged
+    case 0x1D:
+    case CMD_SET_BACKGROUND_COLOR:
+    case CMD_SET_BACKGROUND_IMG:
+      return 1;   // command only
+    case CMD_DELETE_OBJ:
+    case CMD_SET_TOP_OBJ:
+    case CMD_SET_ANGLE_OBJ:
+    case CMD_OF_DRAW_LINE_CHART_TEXT:
+      return 3;   // command, object type (or chart) and ID (or axis)
+    default:
+      return 2;   // command and object ID
+  }
+}
+
+uint8_t DFRobot_LcdDisplay::objectType(uint8_t cmd)
+{
+  switch (cmd) {
+    case CMD_OF_DRAW_ICON_EXTERNAL:
+      return CMD_OF_DRAW_ICON_INTERNAL;
+    case CMD_OF_DRAW_GIF_EXTERNAL:
+      return CMD_OF_DRAW_GIF_INTERNAL;
+    default:
+      return cmd;
+  }
+}
+
+bool DFRobot_LcdDisplay::isValueCommand(uint8_t cmd)
+{
+  switch (cmd) {
+    case CMD_OF_DRAW_BAR_VALUE:
+    case CMD_OF_DRAW_SLIDER_VALUE:
+    case CMD_OF_DRAW_COMPASS_VALUE:
+    case CMD_OF_DRAW_LINE_METER_VALUE:
+    case CMD_OF_DRAW_GAUGE_VALUE:
+    case CMD_SET_ANGLE_OBJ:
+      return true;
+    default:
+      return false;
+  }
+}
+
+#if !LCD_DISABLE_ASYNC
+bool DFRobot_LcdDisplay::enqueueCommand(uint8_t* pBuf, uint16_t len, uint16_t settle)
+{
+  bool value = isValueCommand(pBuf[3]);
+  sLcdQueue_t* queue = &_txQueue;
+  if (value && !queueMentions(&_txQueue, pBuf)) {
+    // Nothing queued that this value has to follow, let it overtake the layout changes
+    queue = &_liveQueue;
+  }
+
+  uint16_t need = len + LCD_QUEUE_ENTRY_HEAD;
+  if (need > queue->size) {
+    // Can never fit, send it directly once everything before it is out
+    drainQueue();
+    sLcdWriteEvent_t event;
+    bool hooked = (_preWrite != NULL) || (_postWrite != NULL);
+    if (hooked) {
+      preWrite(&event, pBuf, len);
+    }
+    writeCommand(pBuf, len);
+    if (settle) {
+      delay(settle);
+    }
+    if (hooked) {
+      postWrite(&event);
+    }
+    LCD_STAT(statFrames(pBuf, len));
+    return true;
+  }
+  if (value && coalesceCommand(queue, pBuf, len)) {
+    // Last writer wins, the queued value has not been sent yet
+    return true;
+  }
+  if (queue->size - queue->count < need) {
+    if ((_queuePolicy == eQueueCoalesce) && coalesceCommand(queue, pBuf, len)) {
+      return true;
+    }
+    if (_queuePolicy == eQueueDrop) {
+      _txDropped++;
+#if !LCD_DISABLE_SHADOW
+      if (_shadowing) {
+        // The screen never got it, so the next identical frame must not be skipped
+        shadowForget(pBuf);
+      }
+#endif
+      return false;
+    }
+    // eQueueBlock, or nothing to coalesce with: wait for room
+    while (queue->size - queue->count < need) {
+      sendQueued();
+      yield();
+    }
+  }
+
+  uint16_t deadline = 0;
+  if (_deadline && (queue == &_txQueue)) {
+    deadline = (uint16_t)(millis() + _deadline);
+    if (deadline == 0) {
+      deadline = 1;   // 0 means no deadline
+    }
+  }
+  uint16_t pos = queue->head;
+  queue->buf[pos] = (settle > 2550) ? 255 : (settle + 9) / 10;
+  queue->buf[ringIndex(queue, pos + 1)] = deadline >> 8;
+  queue->buf[ringIndex(queue, pos + 2)] = deadline & 0xFF;
+  for (uint16_t i = 0; i < len; i++) {
+    queue->buf[ringIndex(queue, pos + LCD_QUEUE_ENTRY_HEAD + i)] = pBuf[i];
+  }
+  queue->head = ringIndex(queue, pos + need);
+  queue->count += need;
+  queue->frames++;
+  return true;
+}
+
+bool DFRobot_LcdDisplay::coalesceCommand(sLcdQueue_t* queue, uint8_t* pBuf, uint16_t len)
+{
+  uint8_t keyLen = frameKeyLen(pBuf[3]);
+  if (keyLen == 0) {
+    return false;
+  }
+  const uint16_t none = 0xFFFF;
+  uint16_t match = none;
+  uint16_t pos = queue->tail;
+  for (uint16_t n = 0; n < queue->frames; n++) {
+    uint16_t frameLen = queueFrameLen(queue, pos);
+    uint8_t cmd = queue->buf[ringIndex(queue, pos + LCD_QUEUE_ENTRY_HEAD + 3)];
+    // The oldest frame may already be partly on the wire
+    bool inFlight = (n == 0) && (queue->offset != 0);
+    bool same = !inFlight && (frameLen == len);
+    for (uint8_t k = 0; same && (k < keyLen); k++) {
+      same = (queue->buf[ringIndex(queue, pos + LCD_QUEUE_ENTRY_HEAD + 3 + k)] == pBuf[3 + k]);
+    }
+    if (same) {
+      match = pos;
+    } else if ((cmd == CMD_DELETE_OBJ) || (cmd == 0x1D)) {
+      // Never move a frame to before a delete or a clear
+      match = none;
+    }
+    pos = ringIndex(queue, pos + LCD_QUEUE_ENTRY_HEAD + frameLen);
+  }
+  if (match == none) {
+    return false;
+  }
+  for (uint16_t i = 0; i < len; i++) {
+    queue->buf[ringIndex(queue, match + LCD_QUEUE_ENTRY_HEAD + i)] = pBuf[i];
+  }
+  _coalesced++;
+  return true;
+}
+
+bool DFRobot_LcdDisplay::queueMentions(sLcdQueue_t* queue, uint8_t* pBuf)
+{
+  // The object a value frame is about: its draw command and ID
+  bool angle = (pBuf[3] == CMD_SET_ANGLE_OBJ);
+  uint8_t type = angle ? pBuf[4] : pBuf[3] - 1;
+  uint8_t id = angle ? pBuf[5] : pBuf[4];
+
+  uint16_t pos = queue->tail;
+  for (uint16_t n = 0; n < queue->frames; n++) {
+    uint16_t frameLen = queueFrameLen(queue, pos);
+    uint8_t frame[6] = {0};
+    for (uint8_t i = 3; (i < sizeof(frame)) && (i < frameLen); i++) {
+      frame[i] = queue->buf[ringIndex(queue, pos + LCD_QUEUE_ENTRY_HEAD + i)];
+    }
+    switch (frame[3]) {
+      case 0x1D:
+        return true;
+      case CMD_DELETE_OBJ:
+      case CMD_SET_TOP_OBJ:
+      case CMD_SET_ANGLE_OBJ:
+        if ((frame[4] == type) && (frame[5] == id)) {
+          return true;
+        }
+        break;
+      default:
+        if (((objectType(frame[3]) == type) || (frame[3] == pBuf[3])) && (frame[4] == id)) {
+          return true;
+        }
+        break;
+    }
+    pos = ringIndex(queue, pos + LCD_QUEUE_ENTRY_HEAD + frameLen);
+  }
+  return false;
+}
+
+uint16_t DFRobot_LcdDisplay::queueFrameLen(sLcdQueue_t* queue, uint16_t pos)
+{
+  return queue->buf[ringIndex(queue, pos + LCD_QUEUE_ENTRY_HEAD + 2)] + CMDLEN_OF_HEAD_LEN;
+}
+
+bool DFRobot_LcdDisplay::queueExpired(sLcdQueue_t* queue, uint16_t pos)
+{
+  uint16_t deadline = (queue->buf[ringIndex(queue, pos + 1)] << 8) | queue->buf[ringIndex(queue, pos + 2)];
+  return deadline && ((int16_t)((uint16_t)millis() - deadline) > 0);
+}
+
+void DFRobot_LcdDisplay::dropExpired()
+{
+  while (_txQueue.frames && (_txQueue.offset == 0) && queueExpired(&_txQueue, _txQueue.tail)) {
+    uint16_t need = LCD_QUEUE_ENTRY_HEAD + queueFrameLen(&_txQueue, _txQueue.tail);
+#if !LCD_DISABLE_SHADOW
+    if (_shadowing) {
+      // The module never gets this frame, so the cache must not claim it did
+      uint8_t head[6] = {0};
+      for (uint8_t i = 0; (i < sizeof(head)) && (i < need - LCD_QUEUE_ENTRY_HEAD); i++) {
+        head[i] = _txQueue.buf[ringIndex(&_txQueue, _txQueue.tail + LCD_QUEUE_ENTRY_HEAD + i)];
+      }
+      shadowForget(head);
+    }
+#endif
+    _txQueue.tail = ringIndex(&_txQueue, _txQueue.tail + need);
+    _txQueue.count -= need;
+    _txQueue.frames--;
+    _txDropped++;
+  }
+}
+#endif
+
+#if !LCD_DISABLE_BATCH
+bool DFRobot_LcdDisplay::coalesceBatch(uint8_t* pBuf, uint16_t len)
+{
+  uint8_t keyLen = frameKeyLen(pBuf[3]);
+  uint8_t* match = NULL;
+  uint16_t pos = 0;
+  while (pos < _batchLen) {
+    uint8_t* frame = _batchBuf + pos;
+    uint16_t frameLen = frame[2] + CMDLEN_OF_HEAD_LEN;
+    if ((frameLen == len) && (memcmp(frame + 3, pBuf + 3, keyLen) == 0)) {
+      match = frame;
+    } else if ((frame[3] == CMD_DELETE_OBJ) || (frame[3] == 0x1D)) {
+      // Never move a frame to before a delete or a clear
+      match = NULL;
+    }
+    pos += frameLen;
+  }
+  if (match == NULL) {
+    return false;
+  }
+  memcpy(match, pBuf, len);
+  _coalesced++;
+  return true;
+}
+#endif
+
+#if !LCD_DISABLE_ASYNC
+uint16_t DFRobot_LcdDisplay::peekQueue(sLcdQueue_t* queue, uint8_t* pBuf, uint16_t maxLen)
+{
+  uint16_t pos = queue->tail;
+  uint16_t offset = queue->offset;
+  uint16_t len = 0;
+  for (uint16_t n = 0; (n < queue->frames) && (len < maxLen); n++) {
+    uint16_t frameLen = queueFrameLen(queue, pos);
+    if ((n > 0) && queueExpired(queue, pos)) {
+      // Leave it for dropExpired()
+      break;
+    }
+    while ((offset < frameLen) && (len < maxLen)) {
+      pBuf[len++] = queue->buf[ringIndex(queue, pos + LCD_QUEUE_ENTRY_HEAD + offset)];
+      offset++;
+    }
+    if ((offset < frameLen) || queue->buf[pos]) {
+      // Frame split across chunks, or the screen needs time after it
+      break;
+    }
+    pos = ringIndex(queue, pos + LCD_QUEUE_ENTRY_HEAD + frameLen);
+    offset = 0;
+  }
+  return len;
+}
+
+uint8_t DFRobot_LcdDisplay::consumeQueue(sLcdQueue_t* queue, uint16_t len)
+{
+  uint8_t settle = 0;
+  while (len) {
+    uint16_t frameLen = queueFrameLen(queue, queue->tail);
+    uint16_t left = frameLen - queue->offset;
+    if (len < left) {
+      queue->offset += len;
+      break;
+    }
+    len -= left;
+    if (queue->buf[queue->tail] > settle) {
+      settle = queue->buf[queue->tail];
+    }
+    LCD_STAT(statFrame(queue->buf[ringIndex(queue, queue->tail + LCD_QUEUE_ENTRY_HEAD + 3)]));
+    queue->tail = ringIndex(queue, queue->tail + LCD_QUEUE_ENTRY_HEAD + frameLen);
+    queue->count -= LCD_QUEUE_ENTRY_HEAD + frameLen;
+    queue->frames--;
+    queue->offset = 0;
+  }
+  return settle;
+}
+#endif
+
+void DFRobot_LcdDisplay::setFlowControl(bool enable, uint16_t timeout)
+{
+  _flowControl = enable;
+  _ackTimeout = timeout;
+}
+
+void DFRobot_LcdDisplay::waitReady()
+{
+  if (!_flowControl) {
+    delay(LCD_SETTLE_TIME_MS);
+    return;
+  }
+  unsigned long start = millis();
+  while (!pollACK()) {
+    if ((millis() - start) >= _ackTimeout) {
+      LCD_STAT(_stats.ackTimeouts++);
+      break;
+    }
+  }
+}
+
+bool DFRobot_LcdDisplay::parseResponse(bool headerOnly)
+{
+  // Bounded so that a bus returning endless garbage cannot keep us here
+  for (uint8_t step = 0; step < LCD_RESPONSE_BUF_LEN; step++) {
+    uint16_t need;
+    if (_rxLen < 2) {
+      need = 2 - _rxLen;
+    } else if (headerOnly) {
+      return true;
+    } else if (_rxLen == 2) {
+      need = 1;
+    } else {
+      need = _rxBuf[2] + CMDLEN_OF_HEAD_LEN - _rxLen;
+      if (need == 0) {
+        return true;
+      }
+    }
+
+    uint16_t got;
+    if (_rxLen < 2) {
+      // Scan byte by byte until the header lines up
+      uint8_t data[2];
+      got = readChunk(data, need);
+      for (uint16_t i = 0; i < got; i++) {
+        if (_rxLen == 1 && data[i] != CMD_HEADER_LOW) {
+          _rxLen = 0;
+        }
+        if ((_rxLen == 0 && data[i] == CMD_HEADER_HIGH) || _rxLen == 1) {
+          _rxBuf[_rxLen++] = data[i];
+        }
+      }
+    } else {
+      got = readChunk(&_rxBuf[_rxLen], need);
+      if (_rxLen == 2 && got && (_rxBuf[2] + CMDLEN_OF_HEAD_LEN > LCD_RESPONSE_BUF_LEN)) {
+        _lastError = eLcdLongResponse;
+        LCD_STAT(_stats.longResponses++);
+        _rxLen = 0;
+        continue;
+      }
+      _rxLen += got;
+    }
+    if (got == 0) {
+      break;
+    }
+  }
+  return false;
+}
+
+uint16_t DFRobot_LcdDisplay::readACK(uint8_t* pBuf, uint16_t len, uint16_t timeout)
+{
+  unsigned long start = millis();
+  while (!parseResponse(false)) {
+    if ((millis() - start) >= timeout) {
+      return 0;
+    }
+  }
+  if (len > _rxLen) {
+    len = _rxLen;
+  }
+  if (pBuf != NULL) {
+    memcpy(pBuf, _rxBuf, len);
+  }
+  _rxLen = 0;
+  return len;
+}
+
+bool DFRobot_LcdDisplay::pollACK()
+{
+  if (!parseResponse(true)) {
+    return false;
+  }
+  _rxLen = 0;
+  return true;
+}
+
+#ifdef ARDUINO
+DFRobot_Lcd_IIC::DFRobot_Lcd_IIC(TwoWire* pWire, uint8_t addr, uint16_t chunkSize)
+  : DFRobot_LcdDisplay(writePieces, readPieces)
+{
+  _deviceAddr = addr;
+  _pWire = pWire;
+  _chunkSize = chunkSize ? chunkSize : LCD_I2C_CHUNK_SIZE;
+  _clock = LCD_I2C_CLOCK_DEFAULT;
+
+}
+
+bool DFRobot_Lcd_IIC::begin(uint32_t clock)
+{
+  if (_pWire == NULL) return false;
+  _pWire->begin();
+  if (clock == LCD_I2C_CLOCK_AUTO) {
+    return probeClock() != 0;
+  }
+  _clock = clock;
+  _pWire->setClock(_clock);
+  _pWire->beginTransmission(_deviceAddr);
+  if (_pWire->endTransmission() != 0) return false;
+
+  return true;
+}
+
+uint32_t DFRobot_Lcd_IIC::probeClock(uint32_t maxClock)
+{
+  static const uint32_t rates[] = {100000, 400000, 1000000};
+  uint32_t best = 0;
+
+  for (uint8_t i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+    if (rates[i] > maxClock) {
+      break;
+    }
+    _pWire->setClock(rates[i]);
+    uint8_t acked = 0;
+    while (acked < LCD_I2C_PROBE_TRIES) {
+      _pWire->beginTransmission(_deviceAddr);
+      if (_pWire->endTransmission() != 0) {
+        break;
+      }
+      acked++;
+    }
+    if (acked < LCD_I2C_PROBE_TRIES) {
+      break;
+    }
+    best = rates[i];
+  }
+
+  _clock = best ? best : LCD_I2C_CLOCK_DEFAULT;
+  _pWire->setClock(_clock);
+  return best;
+}
+
+uint32_t DFRobot_Lcd_IIC::getClock()
+{
+  return _clock;
+}
+
+uint16_t DFRobot_Lcd_IIC::writePieces(DFRobot_LcdDisplay* self, const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen)
+{
+  DFRobot_Lcd_IIC* lcd = static_cast<DFRobot_Lcd_IIC*>(self);
+  uint16_t currentTransferSize = (len + moreLen < lcd->_chunkSize) ? len + moreLen : lcd->_chunkSize;
+  uint16_t first = (len < currentTransferSize) ? len : currentTransferSize;
+
+  uint8_t ret = 0;
+  for (uint8_t i = 0; i <= lcd->_mirrorNum; i++) {
+    lcd->_pWire->beginTransmission((i == 0) ? lcd->_deviceAddr : lcd->_mirrorAddr[i - 1]);
+    lcd->_pWire->write(pBuf, first);
+    if (currentTransferSize > first) {
+      lcd->_pWire->write(more, currentTransferSize - first);
+    }
+    ret = lcd->_pWire->endTransmission();
+    LCD_STAT(if (ret != 0) lcd->_stats.failedTransactions++);
+  }
+  LCD_UNUSED(ret);
+
+  LCD_STAT(lcd->statChunk(currentTransferSize, 1 + lcd->_mirrorNum));
+  return currentTransferSize;
+}
+
+bool DFRobot_Lcd_IIC::addMirror(uint8_t addr)
+{
+  if (_mirrorNum >= LCD_I2C_MAX_MIRRORS) {
+    return false;
+  }
+  _pWire->beginTransmission(addr);
+  if (_pWire->endTransmission() != 0) {
+    return false;
+  }
+  _mirrorAddr[_mirrorNum++] = addr;
+  return true;
+}
+
+uint16_t DFRobot_Lcd_IIC::readPieces(DFRobot_LcdDisplay* self, uint8_t* pBuf, uint16_t len)
+{
+  DFRobot_Lcd_IIC* lcd = static_cast<DFRobot_Lcd_IIC*>(self);
+  if (len > lcd->_chunkSize) {
+    len = lcd->_chunkSize;
+  }
+  uint8_t got = lcd->_pWire->requestFrom(lcd->_deviceAddr, (uint8_t)len);
+  for (uint8_t i = 0; i < got; i++) {
+    pBuf[i] = lcd->_pWire->read();
+  }
+  return got;
+}
+#endif
+
+DFRobot_Lcd_UART::DFRobot_Lcd_UART(Stream& s)
+  : DFRobot_LcdDisplay(writePieces, readPieces)
+{
+  _s = &s;
+}
+
+bool DFRobot_Lcd_UART::begin()
+{
+  // warning: the compiler can assume that the address of 's' will never be NULL
+  if (_s == NULL) {
+    return false;
+  }
+  return true;
+}
+
+uint16_t DFRobot_Lcd_UART::writePieces(DFRobot_LcdDisplay* self, const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen)
+{
+  DFRobot_Lcd_UART* lcd = static_cast<DFRobot_Lcd_UART*>(self);
+  if (lcd->_flowControl) {
+    // Drop late acknowledgements of earlier writes so they are not taken for this one
+    while (lcd->_s->available()) {
+      lcd->_s->read();
+    }
+    lcd->_rxLen = 0;
+  }
+  lcd->_s->write(pBuf, len);
+  if (moreLen) {
+    lcd->_s->write(more, moreLen);
+  }
+  LCD_STAT(lcd->statChunk(len + moreLen, 1));
+  return len + moreLen;
+}
+
+uint16_t DFRobot_Lcd_UART::readPieces(DFRobot_LcdDisplay* self, uint8_t* pBuf, uint16_t len)
+{
+  DFRobot_Lcd_UART* lcd = static_cast<DFRobot_Lcd_UART*>(self);
+  uint16_t got = 0;
+  while ((got < len) && lcd->_s->available()) {
+    pBuf[got++] = lcd->_s->read();
+  }
+  return got;
+}
+
+#ifdef ARDUINO
+DFRobot_LcdWireTransport::DFRobot_LcdWireTransport(TwoWire* pWire, uint8_t addr, uint16_t chunkSize)
+{
+  _pWire = pWire;
+  _deviceAddr = addr;
+  _chunkSize = chunkSize ? chunkSize : LCD_I2C_CHUNK_SIZE;
+}
+
+bool DFRobot_LcdWireTransport::begin()
+{
+  if (_pWire == NULL) return false;
+  _pWire->begin();
+  _pWire->beginTransmission(_deviceAddr);
+  return _pWire->endTransmission() == 0;
+}
+
+uint16_t DFRobot_LcdWireTransport::write(const uint8_t* pBuf, uint16_t len)
+{
+  return write(pBuf, len, NULL, 0);
+}
+
+uint16_t DFRobot_LcdWireTransport::write(const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen)
+{
+  uint16_t currentTransferSize = (len + moreLen < _chunkSize) ? len + moreLen : _chunkSize;
+  uint16_t first = (len < currentTransferSize) ? len : currentTransferSize;
+  _pWire->beginTransmission(_deviceAddr);
+  _pWire->write(pBuf, first);
+  if (currentTransferSize > first) {
+    _pWire->write(more, currentTransferSize - first);
+  }
+  if (_pWire->endTransmission() != 0) {
+    return 0;
+  }
+  return currentTransferSize;
+}
+
+uint16_t DFRobot_LcdWireTransport::read(uint8_t* pBuf, uint16_t len)
+{
+  if (len > _chunkSize) {
+    len = _chunkSize;
+  }
+  uint8_t got = _pWire->requestFrom(_deviceAddr, (uint8_t)len);
+  for (uint8_t i = 0; i < got; i++) {
+    pBuf[i] = _pWire->read();
+  }
+  return got;
+}
+#endif
+
+DFRobot_LcdStreamTransport::DFRobot_LcdStreamTransport(Stream& s)
+{
+  _s = &s;
+}
+
+bool DFRobot_LcdStreamTransport::begin()
+{
+  return true;
+}
+
+uint16_t DFRobot_LcdStreamTransport::write(const uint8_t* pBuf, uint16_t len)
+{
+  _s->write(pBuf, len);
+  return len;
+}
+
+uint16_t DFRobot_LcdStreamTransport::write(const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen)
+{
+  _s->write(pBuf, len);
+  _s->write(more, moreLen);
+  return len + moreLen;
+}
+
+uint16_t DFRobot_LcdStreamTransport::read(uint8_t* pBuf, uint16_t len)
+{
+  uint16_t got = 0;
+  while ((got < len) && _s->available()) {
+    pBuf[got++] = _s->read();
+  }
+  return got;
+}
+
+void DFRobot_LcdStreamTransport::discard()
+{
+  while (_s->available()) {
+    _s->read();
+  }
+}
+
+#if !LCD_DISABLE_ASYNC
+DFRobot_LcdGroup::DFRobot_LcdGroup()
+{
+  _num = 0;
+  _next = 0;
+}
+
+bool DFRobot_LcdGroup::add(DFRobot_LcdDisplay& lcd, DFRobot_LcdDisplay::sLcdQueuePolicy_t policy)
+{
+  if (_num >= LCD_GROUP_MAX_DISPLAYS) {
+    return false;
+  }
+  lcd.setAsync(true, policy);
+  _displays[_num++] = &lcd;
+  return true;
+}
+
+void DFRobot_LcdGroup::poll()
+{
+  for (uint8_t i = 0; i < _num; i++) {
+    _displays[(_next + i) % _num]->poll();
+  }
+  if (_num) {
+    _next = (_next + 1) % _num;
+  }
+}
+
+uint16_t DFRobot_LcdGroup::queueDepth()
+{
+  uint16_t depth = 0;
+  for (uint8_t i = 0; i < _num; i++) {
+    depth += _displays[i]->queueDepth();
+  }
+  return depth;
+}
+
+void DFRobot_LcdGroup::flush()
+{
+#if !LCD_DISABLE_BATCH
+  for (uint8_t i = 0; i < _num; i++) {
+    _displays[i]->flush();
+  }
+#endif
+  while (queueDepth()) {
+    poll();
+    yield();
+  }
+}
+#endif
+
+#if !LCD_DISABLE_TEXT
+static const uint8_t clockColumns[5] = {0, 2, 3, 5, 6};   // character column of each time object
+
+// Two digits of v, without a terminating NUL
+static const char* clockDigits(char* buf, uint8_t v)
+{
+  buf[0] = '0' + v / 10 % 10;
+  buf[1] = '0' + v % 10;
+  return buf;
+}
+
+static uint8_t daysInMonth(uint16_t year, uint8_t month)
+{
+  static const uint8_t days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  if ((month == 2) && (year % 4 == 0) && ((year % 100 != 0) || (year % 400 == 0))) {
+    return 29;
+  }
+  return ((month >= 1) && (month <= 12)) ? days[month - 1] : 31;
+}
+
+DFRobot_LcdClock::DFRobot_LcdClock(DFRobot_LcdDisplay& lcd)
+{
+  _lcd = &lcd;
+  _source = NULL;
+  _time.year = 2000;
+  _time.month = 1;
+  _time.day = 1;
+  _time.weekday = 6;
+  _time.hour = 0;
+  _time.minute = 0;
+  _time.second = 0;
+  _since = millis();
+  memset(_timeIds, 0, sizeof(_timeIds));
+  _dateId = 0;
+}
+
+void DFRobot_LcdClock::setTime(uint8_t hour, uint8_t minute, uint8_t second)
+{
+  _time.hour = hour;
+  _time.minute = minute;
+  _time.second = second;
+  _since = millis();
+}
+
+void DFRobot_LcdClock::setDate(uint16_t year, uint8_t month, uint8_t day, uint8_t weekday)
+{
+  _time.year = year;
+  _time.month = month;
+  _time.day = day;
+  _time.weekday = weekday;
+}
+
+void DFRobot_LcdClock::setTimeSource(sLcdClockSource_t source)
+{
+  _source = source;
+  _since = millis();
+}
+
+void DFRobot_LcdClock::readTime()
+{
+  if (_source) {
+    _source(&_time);
+    return;
+  }
+  uint32_t elapsed = (millis() - _since) / 1000;
+  if (elapsed == 0) {
+    return;
+  }
+  _since += elapsed * 1000;
+  uint32_t seconds = _time.second + 60UL * (_time.minute + 60UL * _time.hour) + elapsed;
+  _time.hour = seconds / 3600 % 24;
+  _time.minute = seconds / 60 % 60;
+  _time.second = seconds % 60;
+  for (uint32_t days = seconds / 86400; days; days--) {
+    _time.weekday = _time.weekday % 7 + 1;
+    if (++_time.day > daysInMonth(_time.year, _time.month)) {
+      _time.day = 1;
+      if (++_time.month > 12) {
+        _time.month = 1;
+        _time.year++;
+      }
+    }
+  }
+}
+
+bool DFRobot_LcdClock::drawTime(uint16_t x, uint16_t y, uint8_t fontSize, uint32_t color)
+{
+  deleteTime();
+  readTime();
+  _timeX = x;
+  _timeY = y;
+  _timeFont = fontSize;
+  _timeColor = color;
+  _charWidth = fontSize ? LCD_CLOCK_CHAR_WIDTH_12PX : LCD_CLOCK_CHAR_WIDTH_24PX;
+  _shown[0] = _time.hour;
+  _shown[1] = _time.minute;
+  _shown[2] = _time.second;
+  for (uint8_t i = 0; i < 5; i++) {
+    char digits[2];
+    const char* text = (i % 2) ? ":" : clockDigits(digits, _shown[i / 2]);
+    _timeIds[i] = _lcd->drawString(x + clockColumns[i] * _charWidth, y, text, (i % 2) ? 1 : 2, fontSize, color);
+    if (_timeIds[i] == 0) {
+      deleteTime();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool DFRobot_LcdClock::drawDate(uint16_t x, uint16_t y, uint8_t fontSize, uint32_t color)
+{
+  deleteDate();
+  readTime();
+  _dateX = x;
+  _dateY = y;
+  _dateFont = fontSize;
+  _dateColor = color;
+  _dateId = sendDate(0);
+  return _dateId != 0;
+}
+
+uint8_t DFRobot_LcdClock::sendDate(uint8_t id)
+{
+  // Same text as drawLcdDate(): 03月29日 周三
+  uint8_t weekday = ((_time.weekday >= 1) && (_time.weekday <= 7)) ? _time.weekday : 0;
+  const char* name = &"一二三四五六日"[weekday ? (weekday - 1) * 3 : 0];   // 3 bytes per character in UTF-8
+  _shownDate = (_time.month << 5) | _time.day;
+  if (id == 0) {
+    return _lcd->drawStringf(_dateX, _dateY, _dateFont, _dateColor, "%02u月%02u日 周%.*s",
+                             (unsigned)_time.month, (unsigned)_time.day, weekday ? 3 : 0, name);
+  }
+  _lcd->updateStringf(id, _dateX, _dateY, _dateFont, _dateColor, "%02u月%02u日 周%.*s",
+                      (unsigned)_time.month, (unsigned)_time.day, weekday ? 3 : 0, name);
+  return id;
+}
+
+uint8_t DFRobot_LcdClock::tick()
+{
+  readTime();
+  uint8_t frames = 0;
+  if (_timeIds[0]) {
+    const uint8_t now[3] = {_time.hour, _time.minute, _time.second};
+    for (uint8_t i = 0; i < 3; i++) {
+      if (now[i] != _shown[i]) {
+        char digits[2];
+        _lcd->updateString(_timeIds[i * 2], _timeX + clockColumns[i * 2] * _charWidth, _timeY,
+                           clockDigits(digits, now[i]), 2, _timeFont, _timeColor);
+        _shown[i] = now[i];
+        frames++;
+      }
+    }
+  }
+  if (_dateId && (((_time.month << 5) | _time.day) != _shownDate)) {
+    sendDate(_dateId);
+    frames++;
+  }
+  return frames;
+}
+
+void DFRobot_LcdClock::deleteTime()
+{
+  for (uint8_t i = 0; i < 5; i++) {
+    if (_timeIds[i]) {
+      _lcd->deleteString(_timeIds[i]);
+      _timeIds[i] = 0;
+    }
+  }
+}
+
+void DFRobot_LcdClock::deleteDate()
+{
+  if (_dateId) {
+    _lcd->deleteString(_dateId);
+    _dateId = 0;
   }
-  DBG("read error");
 }
+#endif
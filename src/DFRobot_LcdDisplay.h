@@ -13,11 +13,23 @@
  */
 #ifndef DFROBOT_LCDDISPLAY_H_
 #define DFROBOT_LCDDISPLAY_H_
+#ifdef ARDUINO
 #include <Wire.h>
 #include <Arduino.h>
 #include <String.h>
+#else
+#include "DFRobot_LcdPosix.h"
+#endif
+#include <stdarg.h>
+#include "DFRobot_LcdLinux.h"
 
-#ifndef ENABLE_DBG
+#ifndef ARDUINO
+// No Serial to print to outside an Arduino core
+# ifdef DBG
+#  undef DBG
+# endif
+# define DBG(...)
+#elif !defined(ENABLE_DBG)
   # define ENABLE_DBG   //!< Open this macro and you can see the details of the program
 # ifdef ENABLE_DBG
 #   ifdef DBG
@@ -51,6 +63,7 @@
 
 // cmd len
 #define CMDLEN_OF_HEAD_LEN         3
+#define LCD_FRAME_MAX_LEN             0xFF  //!< The frame length field is one byte, so no frame is longer than this
 #define CMD_DELETE_OBJ_LEN            0x06
 #define CMD_SET_TOP_OBJ_LEN           0x06
 #define CMD_SET_COMPASS_VALUE_LEN     0x07
@@ -63,6 +76,7 @@
 #define CMD_DRAW_COMPASS_LEN          0x0B
 #define CMD_DRAW_CHART_LEN            0x09
 #define CMD_DRAW_SERIE_LEN            0x09
+#define CMD_DRAW_SERIE_POINT_LEN      0x0A
 #define CMD_OF_DRAW_ICON_INTERNAL_LEN 0x0D
 #define CMD_OF_DRAW_GIF_INTERNAL_LEN  0x0D
 #define CMD_OF_DRAW_BAR_LEN           0x10
@@ -74,6 +88,27 @@
 #define CMD_OF_DRAW_LINE_METER_LEN    0x15
 #define CMD_OF_DRAW_RECT_LEN          0x16
 #define CMD_OF_DRAW_TRIANGLE_LEN      0x19
+#define LCD_FIELDS_FRAME_MAX_LEN      CMD_OF_DRAW_TRIANGLE_LEN  //!< Longest frame built by sendFields()
+#define LCD_TEXT_HEAD_MAX_LEN         0x0D  //!< Longest part in front of the text of a frame built by sendText() (drawString())
+
+// frame layout
+/**
+ * @fn lcdLayout
+ * @brief Describe the payload of a fixed-length frame as the byte width (1 to 3) of each field in frame order
+ * @n Packed two bits per field, first field in the lowest bits, so a layout is a single constant; see DFRobot_LcdDisplay::sendFields()
+ * @return The layout
+ */
+constexpr uint32_t lcdLayout() { return 0; }
+template<typename... Widths>
+constexpr uint32_t lcdLayout(uint8_t width, Widths... widths) { return width | (lcdLayout(widths...) << 2); }
+
+/**
+ * @fn lcdLayoutLen
+ * @brief Number of payload bytes a layout describes, for checking it against the CMD_*_LEN constants
+ * @param layout Layout from lcdLayout()
+ * @return Bytes
+ */
+constexpr uint8_t lcdLayoutLen(uint32_t layout) { return layout ? (layout & 3) + lcdLayoutLen(layout >> 2) : 0; }
 
 // cmd
 #define CMD_SET_BACKGROUND_COLOR      0x19
@@ -105,6 +140,171 @@
 #define CMD_SET_ANGLE_OBJ             0x1E
 #define CMD_OF_DRAW_GIF_INTERNAL      0x1F
 #define CMD_OF_DRAW_GIF_EXTERNAL      0x20
+#define LCD_CMD_NUM                   0x21  //!< Number of command codes, 0 to CMD_OF_DRAW_GIF_EXTERNAL
+
+/**
+ * Size of the buffer that collects frames between beginBatch() and endBatch().
+ * Can be overridden with a compiler flag, e.g. -DLCD_BATCH_BUF_LEN=128
+ */
+#ifndef LCD_BATCH_BUF_LEN
+# if defined(__AVR__)
+#   define LCD_BATCH_BUF_LEN        64
+# else
+#   define LCD_BATCH_BUF_LEN        256
+# endif
+#endif
+
+/**
+ * Largest number of bytes sent in one I2C transaction, taken from the Wire buffer of the core.
+ * Can be overridden with a compiler flag, or per instance through the DFRobot_Lcd_IIC constructor.
+ */
+#ifndef LCD_I2C_CHUNK_SIZE
+# if defined(I2C_BUFFER_LENGTH)                               // ESP32
+#   define LCD_I2C_CHUNK_SIZE       I2C_BUFFER_LENGTH
+# elif defined(WIRE_BUFFER_SIZE)                              // RP2040, nRF52
+#   define LCD_I2C_CHUNK_SIZE       WIRE_BUFFER_SIZE
+# elif defined(ARDUINO_ARCH_SAMD) && defined(SERIAL_BUFFER_SIZE) // SAMD, Wire uses a RingBuffer of this size
+#   define LCD_I2C_CHUNK_SIZE       SERIAL_BUFFER_SIZE
+# elif defined(BUFFER_LENGTH)                                 // AVR, ESP8266
+#   define LCD_I2C_CHUNK_SIZE       BUFFER_LENGTH
+# else
+#   define LCD_I2C_CHUNK_SIZE       32
+# endif
+#endif
+
+/**
+ * Size of the ring buffer that holds queued frames in asynchronous mode (see setAsync()),
+ * and of the largest piece poll() hands to the interface at once.
+ * Each queued frame takes its own length plus LCD_QUEUE_ENTRY_HEAD bytes.
+ */
+#ifndef LCD_ASYNC_BUF_LEN
+# if defined(__AVR__)
+#   define LCD_ASYNC_BUF_LEN        128
+# else
+#   define LCD_ASYNC_BUF_LEN        512
+# endif
+#endif
+/**
+ * Size of the second, higher priority queue that holds value updates (setBarValue, setGaugeValue, ...)
+ * so that they overtake queued layout changes.
+ */
+#ifndef LCD_ASYNC_LIVE_BUF_LEN
+# if defined(__AVR__)
+#   define LCD_ASYNC_LIVE_BUF_LEN   48
+# else
+#   define LCD_ASYNC_LIVE_BUF_LEN   128
+# endif
+#endif
+#ifndef LCD_ASYNC_CHUNK_LEN
+# if defined(__AVR__)
+#   define LCD_ASYNC_CHUNK_LEN      32
+# else
+#   define LCD_ASYNC_CHUNK_LEN      128
+# endif
+#endif
+#define LCD_QUEUE_ENTRY_HEAD        3       //!< Bytes in front of each frame in the asynchronous queues
+
+/**
+ * Size of the buffer that collects a response frame from the module (see readACK()).
+ * Longer responses are discarded and reported as eLcdLongResponse by getLastError().
+ */
+#ifndef LCD_RESPONSE_BUF_LEN
+# if defined(__AVR__)
+#   define LCD_RESPONSE_BUF_LEN     16
+# else
+#   define LCD_RESPONSE_BUF_LEN     64
+# endif
+#endif
+
+/**
+ * Number of objects whose last frame the shadow cache remembers (see setShadowCache()).
+ * Each entry takes 7 bytes.
+ */
+#ifndef LCD_SHADOW_CACHE_LEN
+# if defined(__AVR__)
+#   define LCD_SHADOW_CACHE_LEN     8
+# else
+#   define LCD_SHADOW_CACHE_LEN     64
+# endif
+#endif
+
+/**
+ * Feature switches: set one to 1 to leave a family of widgets out of the build, together with its
+ * encoders and its row of the object ID bitmap. Calling a removed method then fails to compile.
+ * They change the layout of DFRobot_LcdDisplay, so they must be the same for the library and the sketch:
+ * set them with compiler flags for the whole build, e.g. -DLCD_DISABLE_CHART=1 -DLCD_DISABLE_GIF=1
+ */
+#ifndef LCD_DISABLE_CHART
+# define LCD_DISABLE_CHART          0   //!< creatChart() and the chart series functions
+#endif
+#ifndef LCD_DISABLE_METER
+# define LCD_DISABLE_METER          0   //!< Gauge, compass and line meter
+#endif
+#ifndef LCD_DISABLE_GIF
+# define LCD_DISABLE_GIF            0   //!< drawGif() and deleteGif()
+#endif
+#ifndef LCD_DISABLE_EXTERNAL_ICON
+# define LCD_DISABLE_EXTERNAL_ICON  0   //!< drawIcon() and updateIcon() with an image path; the built-in icons stay
+#endif
+#ifndef LCD_DISABLE_TEXT
+# define LCD_DISABLE_TEXT           0   //!< drawString(), updateString(), deleteString() and the time and date helpers
+#endif
+
+/**
+ * Mode switches: set one to 1 to leave a way of sending out of the build, together with the buffers
+ * every display object otherwise carries for it. Set them for the whole build like the feature switches.
+ * On AVR they default to 1, so that a display object takes no more RAM than plain immediate sending needs;
+ * build with e.g. -DLCD_DISABLE_ASYNC=0 to use a mode there.
+ */
+#if defined(__AVR__)
+# define LCD_MODE_DEFAULT_OFF       1
+#else
+# define LCD_MODE_DEFAULT_OFF       0
+#endif
+#ifndef LCD_DISABLE_BATCH
+# define LCD_DISABLE_BATCH          LCD_MODE_DEFAULT_OFF   //!< beginBatch(), endBatch(), flush() and the LCD_BATCH_BUF_LEN batch buffer
+#endif
+#ifndef LCD_DISABLE_ASYNC
+# define LCD_DISABLE_ASYNC          LCD_MODE_DEFAULT_OFF   //!< setAsync(), poll() and the other queue functions, DFRobot_LcdGroup and both ring buffers
+#endif
+#ifndef LCD_DISABLE_SHADOW
+# define LCD_DISABLE_SHADOW         LCD_MODE_DEFAULT_OFF   //!< setShadowCache() and the LCD_SHADOW_CACHE_LEN entries of the cache
+#endif
+
+/**
+ * Pixels a DFRobot_LcdClock advances per character of the time, for the 24px and the 12px font.
+ * Can be overridden with compiler flags to fit the spacing of another font.
+ */
+#ifndef LCD_CLOCK_CHAR_WIDTH_24PX
+# define LCD_CLOCK_CHAR_WIDTH_24PX  14
+#endif
+#ifndef LCD_CLOCK_CHAR_WIDTH_12PX
+# define LCD_CLOCK_CHAR_WIDTH_12PX  7
+#endif
+
+/**
+ * Highest object ID handed out per object type (lines, bars, texts, ...). Creating more objects
+ * of one type than this at the same time fails: the create function returns ID 0 and getLastError()
+ * eLcdNoFreeID. The IDs in use are kept in a bitmap of (LCD_MAX_OBJECT_ID + 7) / 8 bytes per type,
+ * 32 bytes with the default of 255; boards short of RAM can lower it, e.g. -DLCD_MAX_OBJECT_ID=63
+ */
+#ifndef LCD_MAX_OBJECT_ID
+# define LCD_MAX_OBJECT_ID          255
+#endif
+#define LCD_ID_MAP_LEN              ((LCD_MAX_OBJECT_ID + 7) / 8)
+#define LCD_OBJECT_TYPE_NUM         (7 + !LCD_DISABLE_GIF + 3 * !LCD_DISABLE_METER + !LCD_DISABLE_TEXT + 2 * !LCD_DISABLE_CHART)
+
+#define LCD_I2C_CLOCK_DEFAULT       100000  //!< I2C clock used by DFRobot_Lcd_IIC::begin() unless told otherwise
+#define LCD_I2C_CLOCK_AUTO          0       //!< Pass to DFRobot_Lcd_IIC::begin() to probe for the fastest clock
+#define LCD_I2C_PROBE_TRIES         8       //!< Consecutive acknowledged pings required to accept a clock rate
+#define LCD_I2C_MAX_MIRRORS         3       //!< Extra addresses a DFRobot_Lcd_IIC can mirror its output to (see addMirror())
+#define LCD_GROUP_MAX_DISPLAYS      4       //!< Displays one DFRobot_LcdGroup can schedule
+#define LCD_TRACE_STAMP_LEN         4       //!< Bytes of the micros() timestamp in front of each frame of a trace (see DFRobot_LcdRecorder)
+
+#define LCD_SETTLE_TIME_MS      50   //!< Fixed time the module is given to process each write when flow control is off
+#ifndef LCD_ACK_TIMEOUT_MS
+# define LCD_ACK_TIMEOUT_MS     50   //!< Default longest wait for the module's acknowledgement when flow control is on
+#endif
 
 #define CMD_HEADER_HIGH         0x55
 #define CMD_HEADER_LOW          0xaa
@@ -113,6 +313,20 @@
 #define LCD_UNUSED(x) ((void) x)
 #endif
 
+/**
+ * Set to 1 to keep the counters returned by getStats(). With 0 (the default) getStats() does not exist
+ * and the counting compiles to nothing. Must be the same for the library and the sketch, so set it
+ * with a compiler flag, e.g. -DLCD_ENABLE_STATS=1
+ */
+#ifndef LCD_ENABLE_STATS
+# define LCD_ENABLE_STATS  0
+#endif
+#if LCD_ENABLE_STATS
+# define LCD_STAT(...)  __VA_ARGS__
+#else
+# define LCD_STAT(...)
+#endif
+
 class DFRobot_LcdDisplay
 {
 public:
@@ -456,29 +670,86 @@ public:
     eGifSun,
   }sLcdGif_t;
 
-  typedef struct chartinfo {
-    uint8_t id; /**<chart ID */
-    struct chartinfo* inf; /**<The next control pointer */
-  }sChartinfo_t;
+  /**
+   * @enum sLcdQueuePolicy_t
+   * @brief What an API call does when the asynchronous queue has no room for its frame
+   */
+  typedef enum {
+    eQueueBlock,      /**<Run poll() until there is room */
+    eQueueDrop,       /**<Discard the new frame and count it (see getDroppedCount()) */
+    eQueueCoalesce,   /**<Overwrite a queued frame for the same object in place, otherwise block */
+  }sLcdQueuePolicy_t;
 
-  typedef struct LineChartNode {
-    uint8_t id;
-    struct LineChartNode* next;
-  } sLineChartNode_t;
+  /**
+   * @enum sLcdError_t
+   * @brief What went wrong, see getLastError()
+   */
+  typedef enum {
+    eLcdOK,
+    eLcdNoFreeID,     /**<A create function found every ID of its object type in use (see LCD_MAX_OBJECT_ID) and returned 0 */
+    eLcdBadTrace,     /**<replay() stopped at a record that was cut short or did not hold a frame */
+    eLcdLongResponse, /**<The module sent a response longer than LCD_RESPONSE_BUF_LEN, it was skipped */
+  }sLcdError_t;
+
+  /**
+   * @struct sShadowEntry_t
+   * @brief Shadow cache entry: which object, and a hash of the last frame sent for it
+   */
+  typedef struct {
+    uint8_t key[3];   /**<Command code (see objectType()) and object key bytes (see frameKeyLen()), key[0] == 0 if unused */
+    uint32_t hash;    /**<FNV-1a hash of the whole frame */
+  }sShadowEntry_t;
+
+#if LCD_ENABLE_STATS
+  /**
+   * @struct sLcdStats_t
+   * @brief Counters kept in the write path, see getStats()
+   */
+  typedef struct {
+    uint32_t frames[LCD_CMD_NUM];   /**<Frames written, indexed by command code */
+    uint32_t bytes;                 /**<Bytes written */
+    uint32_t chunks;                /**<Pieces handed to the interface (one per writeChunk()) */
+    uint32_t transactions;          /**<Bus transactions, more than chunks when mirroring */
+    uint32_t failedTransactions;    /**<I2C transactions the module did not acknowledge, transport writes that sent nothing */
+    uint32_t ackTimeouts;           /**<Flow-control waits that ended without an ACK (see setFlowControl()) */
+    uint32_t longResponses;         /**<Responses longer than LCD_RESPONSE_BUF_LEN, skipped by the parser */
+    uint32_t blockedUs;             /**<Microseconds API calls and poll() spent writing and waiting */
+    uint32_t maxBlockedUs;          /**<Longest single write or poll() in microseconds */
+  }sLcdStats_t;
+#endif
 
+  /**
+   * @struct sLcdWriteEvent_t
+   * @brief What a write hook (see setWriteHooks()) is told about a write
+   */
+  typedef struct {
+    uint8_t cmd;          /**<Command code of the (first) frame written */
+    uint8_t id;           /**<Object ID of that frame, 0 for commands without an object */
+    uint16_t len;         /**<Bytes written */
+    unsigned long start;  /**<micros() when the write started */
+    unsigned long end;    /**<micros() when the write and the settle time were over, 0 in the pre-write hook */
+    const char* file;     /**<Source file of the API call when made through LCD_CALL(), otherwise NULL */
+    uint16_t line;        /**<Source line of the API call when made through LCD_CALL() */
+  }sLcdWriteEvent_t;
 
-  typedef struct GenericNode {
-    uint8_t id;
-    void* next;
-  } sGenericNode_t;
+  typedef void (*sLcdWriteHook_t)(const sLcdWriteEvent_t* event);
 
-public:
   /**
-   * @fn DFRobot_LcdDisplay
-   * @brief constructor
-   * @return None
+   * @struct sLcdQueue_t
+   * @brief Ring buffer of queued frames for asynchronous mode
+   * @n Each entry is a settle time byte (10 ms units), a 16-bit deadline (low bits of millis(), 0 for none), then the frame.
    */
-  DFRobot_LcdDisplay();
+  typedef struct {
+    uint8_t* buf;
+    uint16_t size;
+    uint16_t head;
+    uint16_t tail;
+    uint16_t count;     /**<Bytes in use, entry headers included */
+    uint16_t frames;
+    uint16_t offset;    /**<Bytes of the oldest frame already sent */
+  }sLcdQueue_t;
+
+public:
 
    /**
    * @fn begin
@@ -504,6 +775,24 @@ public:
    */
   void setBackgroundImg(uint8_t location, String str);
 
+  /**
+   * @fn setBackgroundImg
+   * @brief Set the background image object without building a String
+   * @param location Built-in or external images
+   * @param str NUL-terminated picture path, or a path in program memory when passed as F("...")
+   */
+  void setBackgroundImg(uint8_t location, const char* str);
+  void setBackgroundImg(uint8_t location, const __FlashStringHelper* str);
+
+  /**
+   * @fn setBackgroundImg
+   * @brief Set the background image object from the first len bytes of a buffer
+   * @param location Built-in or external images
+   * @param str Picture path, need not be NUL-terminated
+   * @param len Length of the path in bytes
+   */
+  void setBackgroundImg(uint8_t location, const char* str, uint16_t len);
+
   /**
    * @fn cleanScreen
    * @brief Clear the screen to clear all control objects on the screen
@@ -528,7 +817,7 @@ public:
    * @param y1 End Y-coordinate of the line.
    * @param width line width
    * @param color the color of the line, RGB888 format
-   * @return line control handle
+   * @return line control handle, 0 if no ID is free
    */
   uint8_t drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t width, uint32_t color);
 
@@ -565,7 +854,7 @@ public:
    * @param fill fill
    * @param fillColor fill color
    * @param rounded rounded
-   * @return rect control handle
+   * @return rect control handle, 0 if no ID is free
    * 
    */
   uint8_t drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t borderWidth, uint32_t borderColor, uint8_t fill, uint32_t fillColor, uint8_t rounded);
@@ -605,7 +894,7 @@ public:
    * @param borderColor border Color
    * @param fill fill
    * @param fillColor fill color
-   * @return circle control handle
+   * @return circle control handle, 0 if no ID is free
    */
   uint8_t drawCircle(int16_t x, int16_t y, int16_t r, uint8_t borderWidth, uint32_t borderColor, uint8_t fill, uint32_t fillColor);
 
@@ -644,7 +933,7 @@ public:
    * @param borderColor border color
    * @param fill fill
    * @param fillColor fill color
-   * @return triangle control handle
+   * @return triangle control handle, 0 if no ID is free
    */
   uint8_t drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t borderWidth, uint32_t borderColor, uint8_t fill, uint32_t fillColor);
 
@@ -680,10 +969,11 @@ public:
    * @param y The y-coordinate of the first point of the icon
    * @param iconNum The icon's corresponding number
    * @param size Icon scaling factor
-   * @return Icon control handle
+   * @return Icon control handle, 0 if no ID is free
    */
   uint8_t drawIcon(int16_t x, int16_t y, uint16_t iconNum, uint16_t size = 255);
 
+#if !LCD_DISABLE_EXTERNAL_ICON
   /**
    * @fn drawIcon
    * @brief Draw the icon on the USB flash drive
@@ -691,9 +981,34 @@ public:
    * @param y The y-coordinate of the first point of the icon
    * @param str Picture path
    * @param zoom Icon scaling factor
-   * @return Icon control handle
+   * @return Icon control handle, 0 if no ID is free
    */
   uint8_t drawIcon(int16_t x, int16_t y, String str, uint16_t zoom);
+
+  /**
+   * @fn drawIcon
+   * @brief Draw the icon on the USB flash drive without building a String
+   * @param x The x-coordinate of the first point of the icon
+   * @param y The y-coordinate of the first point of the icon
+   * @param str NUL-terminated picture path, or a path in program memory when passed as F("...")
+   * @param zoom Icon scaling factor
+   * @return Icon control handle, 0 if no ID is free
+   */
+  uint8_t drawIcon(int16_t x, int16_t y, const char* str, uint16_t zoom);
+  uint8_t drawIcon(int16_t x, int16_t y, const __FlashStringHelper* str, uint16_t zoom);
+
+  /**
+   * @fn drawIcon
+   * @brief Draw the icon on the USB flash drive from the first len bytes of a path buffer
+   * @param x The x-coordinate of the first point of the icon
+   * @param y The y-coordinate of the first point of the icon
+   * @param str Picture path, need not be NUL-terminated
+   * @param len Length of the path in bytes
+   * @param zoom Icon scaling factor
+   * @return Icon control handle, 0 if no ID is free
+   */
+  uint8_t drawIcon(int16_t x, int16_t y, const char* str, uint16_t len, uint16_t zoom);
+#endif
   
   /**
    * @fn setAngleIcon
@@ -713,6 +1028,7 @@ public:
    */
   void updateIcon(uint8_t iconId, int16_t x, int16_t y, uint16_t iconNum, uint16_t size);
 
+#if !LCD_DISABLE_EXTERNAL_ICON
   /**
    * @fn updateIcon
    * @brief Update icon
@@ -723,6 +1039,29 @@ public:
    */
   void updateIcon(uint8_t iconId, int16_t x, int16_t y, String str, uint16_t zoom);
 
+  /**
+   * @fn updateIcon
+   * @brief Update icon without building a String
+   * @param x The x-coordinate of the first point of the icon
+   * @param y The y-coordinate of the first point of the icon
+   * @param str NUL-terminated icon path, or a path in program memory when passed as F("...")
+   * @param zoom Icon scaling factor
+   */
+  void updateIcon(uint8_t iconId, int16_t x, int16_t y, const char* str, uint16_t zoom);
+  void updateIcon(uint8_t iconId, int16_t x, int16_t y, const __FlashStringHelper* str, uint16_t zoom);
+
+  /**
+   * @fn updateIcon
+   * @brief Update icon from the first len bytes of a path buffer
+   * @param x The x-coordinate of the first point of the icon
+   * @param y The y-coordinate of the first point of the icon
+   * @param str Icon path, need not be NUL-terminated
+   * @param len Length of the path in bytes
+   * @param zoom Icon scaling factor
+   */
+  void updateIcon(uint8_t iconId, int16_t x, int16_t y, const char* str, uint16_t len, uint16_t zoom);
+#endif
+
   /**
    * @fn deleteIcon
    * @brief Delete icon
@@ -730,6 +1069,7 @@ public:
    */
   void deleteIcon(uint8_t id);
 
+#if !LCD_DISABLE_GIF
   /**
    * @fn drawGif
    * @brief Draw gif
@@ -737,7 +1077,7 @@ public:
    * @param y The y-coordinate of the first point of the gif
    * @param gifNum The enumerated value corresponding to the GIF
    * @param size GIF scaling factor
-   * @return GIF control handle
+   * @return GIF control handle, 0 if no ID is free
    */
   uint8_t drawGif(int16_t x, int16_t y, uint16_t gifNum, uint16_t size = 255);
 
@@ -748,16 +1088,41 @@ public:
    * @param y The y-coordinate of the first point of the icon
    * @param str Picture path
    * @param zoom Icon scaling factor
-   * @return Gif control handle
+   * @return Gif control handle, 0 if no ID is free
    */
   uint8_t drawGif(int16_t x, int16_t y, String str, uint16_t zoom);
 
+  /**
+   * @fn drawGif
+   * @brief Draw the gif on the USB flash drive without building a String
+   * @param x The x-coordinate of the first point of the icon
+   * @param y The y-coordinate of the first point of the icon
+   * @param str NUL-terminated picture path, or a path in program memory when passed as F("...")
+   * @param zoom Icon scaling factor
+   * @return Gif control handle, 0 if no ID is free
+   */
+  uint8_t drawGif(int16_t x, int16_t y, const char* str, uint16_t zoom);
+  uint8_t drawGif(int16_t x, int16_t y, const __FlashStringHelper* str, uint16_t zoom);
+
+  /**
+   * @fn drawGif
+   * @brief Draw the gif on the USB flash drive from the first len bytes of a path buffer
+   * @param x The x-coordinate of the first point of the icon
+   * @param y The y-coordinate of the first point of the icon
+   * @param str Picture path, need not be NUL-terminated
+   * @param len Length of the path in bytes
+   * @param zoom Icon scaling factor
+   * @return Gif control handle, 0 if no ID is free
+   */
+  uint8_t drawGif(int16_t x, int16_t y, const char* str, uint16_t len, uint16_t zoom);
+
   /**
    * @fn deleteGif
    * @brief Delete the Gif control
    * @param id Gif control handle
    */
   void deleteGif(uint8_t id);
+#endif
 
   /**
    * @fn creatSlider
@@ -767,7 +1132,7 @@ public:
    * @param width The width of the slider
    * @param height The height of the slide bar
    * @param color The color of the slider
-   * @return Slider control handle
+   * @return Slider control handle, 0 if no ID is free
    */
   uint8_t creatSlider(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color);
 
@@ -807,7 +1172,7 @@ public:
    * @param width Width of the progress bar
    * @param height Height of the progress bar
    * @param color Color of the progress bar
-   * @return Bar control handle
+   * @return Bar control handle, 0 if no ID is free
    */
   uint8_t creatBar(uint16_t x, uint16_t y, uint16_t width, uint8_t height, uint32_t color);
 
@@ -839,6 +1204,7 @@ public:
    */
   void deleteBar(uint8_t id);
 
+#if !LCD_DISABLE_CHART
   /**
    * @fn creatChart
    * @brief Create a chart control
@@ -846,10 +1212,35 @@ public:
    * @param strY Label on the y axis of the chart
    * @param bgColor background color
    * @param type Type of chart (line chart / bar chart)
-   * @return chart control handle
+   * @return chart control handle, 0 if no ID is free
    */
   uint8_t creatChart(String strX, String strY, uint32_t bgColor, uint8_t type);
 
+  /**
+   * @fn creatChart
+   * @brief Create a chart control without building Strings
+   * @param strX NUL-terminated label on the x axis, or a label in program memory when passed as F("...")
+   * @param strY Label on the y axis, given the same way as strX
+   * @param bgColor background color
+   * @param type Type of chart (line chart / bar chart)
+   * @return chart control handle, 0 if no ID is free
+   */
+  uint8_t creatChart(const char* strX, const char* strY, uint32_t bgColor, uint8_t type);
+  uint8_t creatChart(const __FlashStringHelper* strX, const __FlashStringHelper* strY, uint32_t bgColor, uint8_t type);
+
+  /**
+   * @fn creatChart
+   * @brief Create a chart control with axis labels taken from buffers that need not be NUL-terminated
+   * @param strX Label on the x axis of the chart
+   * @param lenX Length of strX in bytes
+   * @param strY Label on the y axis of the chart
+   * @param lenY Length of strY in bytes
+   * @param bgColor background color
+   * @param type Type of chart (line chart / bar chart)
+   * @return chart control handle, 0 if no ID is free
+   */
+  uint8_t creatChart(const char* strX, uint16_t lenX, const char* strY, uint16_t lenY, uint32_t bgColor, uint8_t type);
+
   /**
    * @fn updateChart
    * @brief Update a chart control
@@ -864,7 +1255,7 @@ public:
    * @brief Create a line chart or bar chart sequence in the chart
    * @param chartId chart control handle
    * @param color Color of line chart/bar chart
-   * @return Return the index of the series
+   * @return Return the index of the series, 0 if no ID is free
    */
   uint8_t creatChartSeries(uint8_t chartId, uint32_t color);
 
@@ -912,7 +1303,9 @@ public:
    * @param id chart control handle
    */
   void deleteChart(uint8_t id);
+#endif
 
+#if !LCD_DISABLE_METER
   /**
    * @fn creatGauge
    * @brief Create a dial control
@@ -923,7 +1316,7 @@ public:
    * @param end end value
    * @param pointerColor pointer color
    * @param bgColor background color
-   * @return dial control handle
+   * @return dial control handle, 0 if no ID is free
    */
   uint8_t creatGauge(uint16_t x, uint16_t y, uint16_t diameter, uint16_t start, uint16_t end, uint32_t pointerColor, uint32_t bgColor);
 
@@ -963,7 +1356,7 @@ public:
    * @param x The x-axis coordinate of the control
    * @param y The y-axis coordinate of the control
    * @param diameter  Compass diameter
-   * @return compass control handle
+   * @return compass control handle, 0 if no ID is free
    */
   uint8_t creatCompass(uint16_t x, uint16_t y, uint16_t diameter);
 
@@ -1003,7 +1396,7 @@ public:
    * @param end maximum value
    * @param pointerColor pointer color
    * @param bgColor pointer color
-   * @return linear meter id
+   * @return linear meter id, 0 if no ID is free
    */
   uint8_t creatLineMeter(uint16_t x, uint16_t y, uint16_t size, uint16_t start, uint16_t end, uint32_t pointerColor, uint32_t bgColor);
 
@@ -1044,7 +1437,9 @@ public:
    * @param id LineMeter control handle
    */
   void setTopLineMeter(uint8_t id);
+#endif
 
+#if !LCD_DISABLE_TEXT
   /**
    * @fn drawString
    * @brief Display text on the screen
@@ -1053,9 +1448,36 @@ public:
    * @param str The text to display
    * @param fontSize Text size (only applicable to eChinese and eAscii): 0 (24px size), 1 (12px size)
    * @param color Color of text
+   * @return Text control handle, 0 if no ID is free
    */
   uint8_t drawString(uint16_t x, uint16_t y, String str, uint8_t fontSize, uint32_t color);
 
+  /**
+   * @fn drawString
+   * @brief Display text on the screen without building a String
+   * @param x The x-coordinate of the starting position
+   * @param y The y-coordinate of the starting position
+   * @param str NUL-terminated text, or text in program memory when passed as F("...")
+   * @param fontSize Text size (only applicable to eChinese and eAscii): 0 (24px size), 1 (12px size)
+   * @param color Color of text
+   * @return Text control handle, 0 if no ID is free
+   */
+  uint8_t drawString(uint16_t x, uint16_t y, const char* str, uint8_t fontSize, uint32_t color);
+  uint8_t drawString(uint16_t x, uint16_t y, const __FlashStringHelper* str, uint8_t fontSize, uint32_t color);
+
+  /**
+   * @fn drawString
+   * @brief Display the first len bytes of a text buffer, e.g. one filled by snprintf() or itoa()
+   * @param x The x-coordinate of the starting position
+   * @param y The y-coordinate of the starting position
+   * @param str The text to display, need not be NUL-terminated
+   * @param len Length of the text in bytes
+   * @param fontSize Text size (only applicable to eChinese and eAscii): 0 (24px size), 1 (12px size)
+   * @param color Color of text
+   * @return Text control handle, 0 if no ID is free
+   */
+  uint8_t drawString(uint16_t x, uint16_t y, const char* str, uint16_t len, uint8_t fontSize, uint32_t color);
+
   /**
    * @fn updateString
    * @brief Change text on the screen
@@ -1068,6 +1490,60 @@ public:
    */
   void updateString(uint8_t id, uint16_t x, uint16_t y, String str, uint8_t fontSize, uint32_t color);
 
+  /**
+   * @fn updateString
+   * @brief Change text on the screen without building a String
+   * @param id Text control handle
+   * @param x The x-coordinate of the starting position
+   * @param y The y-coordinate of the starting position
+   * @param str NUL-terminated text, or text in program memory when passed as F("...")
+   * @param fontSize Text size (only applicable to eChinese and eAscii): 0 (24px size), 1 (12px size)
+   * @param color Color of text
+   */
+  void updateString(uint8_t id, uint16_t x, uint16_t y, const char* str, uint8_t fontSize, uint32_t color);
+  void updateString(uint8_t id, uint16_t x, uint16_t y, const __FlashStringHelper* str, uint8_t fontSize, uint32_t color);
+
+  /**
+   * @fn updateString
+   * @brief Change text on the screen to the first len bytes of a text buffer
+   * @param id Text control handle
+   * @param x The x-coordinate of the starting position
+   * @param y The y-coordinate of the starting position
+   * @param str The text to display, need not be NUL-terminated
+   * @param len Length of the text in bytes
+   * @param fontSize Text size (only applicable to eChinese and eAscii): 0 (24px size), 1 (12px size)
+   * @param color Color of text
+   */
+  void updateString(uint8_t id, uint16_t x, uint16_t y, const char* str, uint16_t len, uint8_t fontSize, uint32_t color);
+
+  /**
+   * @fn drawStringf
+   * @brief Display text formatted like printf(), straight into the command frame, e.g. drawStringf(260, 22, 0, ORANGE, "%dlux", lux)
+   * @n No String is built and nothing is allocated. Text longer than 242 bytes is cut off, as in drawString().
+   * @n On AVR the printf() of the core has no %f; print fixed-point values as integers, e.g. "%d.%02d".
+   * @param x The x-coordinate of the starting position
+   * @param y The y-coordinate of the starting position
+   * @param fontSize Text size (only applicable to eChinese and eAscii): 0 (24px size), 1 (12px size)
+   * @param color Color of text
+   * @param format printf() format, also accepted from program memory as F("...")
+   * @return Text control handle, 0 if no ID is free
+   */
+  uint8_t drawStringf(uint16_t x, uint16_t y, uint8_t fontSize, uint32_t color, const char* format, ...);
+  uint8_t drawStringf(uint16_t x, uint16_t y, uint8_t fontSize, uint32_t color, const __FlashStringHelper* format, ...);
+
+  /**
+   * @fn updateStringf
+   * @brief Change text on the screen to text formatted like printf(), see drawStringf()
+   * @param id Text control handle
+   * @param x The x-coordinate of the starting position
+   * @param y The y-coordinate of the starting position
+   * @param fontSize Text size (only applicable to eChinese and eAscii): 0 (24px size), 1 (12px size)
+   * @param color Color of text
+   * @param format printf() format, also accepted from program memory as F("...")
+   */
+  void updateStringf(uint8_t id, uint16_t x, uint16_t y, uint8_t fontSize, uint32_t color, const char* format, ...);
+  void updateStringf(uint8_t id, uint16_t x, uint16_t y, uint8_t fontSize, uint32_t color, const __FlashStringHelper* format, ...);
+
   /**
    * @fn deleteString
    * @brief Delete text on the screen
@@ -1078,6 +1554,7 @@ public:
   /**
    * @fn drawLcdTime
    * @brief Displays the set time on the screen
+   * @n For a clock that ticks, DFRobot_LcdClock resends only the hours, minutes or seconds that changed.
    * @param x The x-coordinate of the starting position
    * @param y The y-coordinate of the starting position
    * @param hour hour
@@ -1085,7 +1562,7 @@ public:
    * @param seconds second
    * @param fontSize font size
    * @param color Color of text
-   * @return time control handle
+   * @return time control handle, 0 if no ID is free
    */
   uint8_t drawLcdTime(uint8_t x, uint8_t y, uint8_t hour, uint8_t Minute, uint8_t seconds, uint8_t fontSize, uint16_t color);
 
@@ -1115,87 +1592,1177 @@ public:
    * @param color Color of text
    */
   void drawLcdDate(uint8_t x, uint8_t y, uint8_t month, uint8_t day, uint8_t weeks, uint8_t fontSize, uint16_t color);
+#endif
 
-private:
-  TwoWire* _pWire;
-  sGenericNode_t *line_chart_head = NULL;
-  sGenericNode_t *series_head = NULL;
-  sGenericNode_t *compass_head = NULL;
-  sGenericNode_t *text_head = NULL;
-  sGenericNode_t *gauge_head = NULL;
-  sGenericNode_t *line_head = NULL;
-  sGenericNode_t *rect_head = NULL;
-  sGenericNode_t *circle_head = NULL;
-  sGenericNode_t *triangle_head = NULL;
-  sGenericNode_t *lineMeter_head = NULL;
-  sGenericNode_t *bar_head = NULL;
-  sGenericNode_t *slider_head = NULL;
-  sGenericNode_t *icon_head = NULL;
-  sGenericNode_t *gif_head = NULL;
-  uint8_t _deviceAddr;
+#if !LCD_DISABLE_BATCH
+  /**
+   * @fn beginBatch
+   * @brief Start collecting commands instead of sending them one by one
+   * @n The frames of all following calls are packed into one buffer (LCD_BATCH_BUF_LEN bytes) and sent
+   * @n back to back, in as few bus transactions as the interface allows. The buffer is sent automatically
+   * @n when it is full, and before commands that need the screen to settle (cleanScreen, setBackgroundColor, creatChart).
+   * @n Value setters (setBarValue, setSliderValue, setGaugeValue, setMeterValue, setCompassScale, setAngleIcon)
+   * @n for an object that already has a value in the batch overwrite it in place, so only the last value is sent.
+   */
+  void beginBatch();
 
-  uint8_t setChartAxisTexts(uint8_t chartId, uint8_t axis, String text);
-  uint8_t getNewID(sGenericNode_t** head);
-  void deleteNodeByID(sGenericNode_t** head, uint8_t id);
-  uint8_t getID(uint8_t type);
+  /**
+   * @fn endBatch
+   * @brief Send all collected commands and return to sending every command immediately
+   */
+  void endBatch();
 
-  uint8_t* creatCommand(uint8_t cmd, uint8_t len);
-  virtual void writeCommand(uint8_t* pBuf, uint16_t len) = 0;
-  virtual void readACK(uint8_t* pBuf, uint16_t len) = 0;
-};
+  /**
+   * @fn flush
+   * @brief Send all collected commands now, and keep collecting afterwards
+   * @n Does nothing if no command is pending.
+   */
+  void flush();
+#endif
 
+  /**
+   * @fn setFlowControl
+   * @brief Wait for the module's acknowledgement after each write instead of a fixed 50 ms sleep
+   * @n When enabled, every write returns as soon as the module acknowledges it, or after timeout ms
+   * @n if no acknowledgement arrives. When disabled (the default), the fixed sleep is used.
+   * @param enable true to poll for the acknowledgement, false to use the fixed sleep
+   * @param timeout Longest wait for one acknowledgement, in ms
+   */
+  void setFlowControl(bool enable, uint16_t timeout = LCD_ACK_TIMEOUT_MS);
 
-class DFRobot_Lcd_IIC: public DFRobot_LcdDisplay
-{
-public:
+#if !LCD_DISABLE_ASYNC
   /**
-   * @fn DFRobot_Lcd_IIC
-   * @brief constructor
-   * @param pWire I2C controller object
-   * @param addr I2C address. The default value is 0x2c
-   * @return None
+   * @fn setAsync
+   * @brief Switch between blocking and asynchronous sending
+   * @n In asynchronous mode API calls only put their frames into a ring buffer (LCD_ASYNC_BUF_LEN bytes)
+   * @n and return at once; poll() must then be called regularly from loop() to send them.
+   * @n Frames too large for the whole ring buffer are still sent blocking.
+   * @n Switching back to blocking mode sends everything that is still queued.
+   * @n As in a batch, a new value for an object whose previous value is still queued replaces it in place.
+   * @n Value updates go to a separate queue (LCD_ASYNC_LIVE_BUF_LEN bytes) that is served first, so a live
+   * @n reading is not held up by layout changes queued before it. A value for an object that still has
+   * @n other frames queued waits behind them.
+   * @param enable true for asynchronous mode, false for blocking mode (the default)
+   * @param policy What to do when the queue is full: eQueueBlock, eQueueDrop or eQueueCoalesce
    */
-  DFRobot_Lcd_IIC(TwoWire* pWire = &Wire, uint8_t addr = 0x2c);
+  void setAsync(bool enable, sLcdQueuePolicy_t policy = eQueueBlock);
 
   /**
-   * @fn begin
-   * @brief Initialize the function to initialize the I2C controller and turn on the screen backlight
-   * @return Boolean type, initialized state
-   * @retval true succeed
-   * @retval false failed
+   * @fn poll
+   * @brief Move queued frames to the interface, call it from loop() in asynchronous mode
+   * @n Sends at most one bus transaction per call and never sleeps: while the screen is still
+   * @n processing the last write it returns immediately.
    */
-  bool begin();
+  void poll();
 
-private:
-  uint8_t _deviceAddr;
-  TwoWire* _pWire;
-  void    writeCommand(uint8_t* pBuf, uint16_t len);
-  void    readACK(uint8_t* pBuf, uint16_t len);
-};
+  /**
+   * @fn setDeadline
+   * @brief Give the layout frames queued from now on a deadline; frames still unsent when it passes are discarded
+   * @n Use it around cosmetic changes that are worthless once late (e.g. a blinking colour), never around
+   * @n creating objects. Only applies in asynchronous mode, value updates are never discarded. Discarded
+   * @n frames are counted by getDroppedCount().
+   * @param ms Deadline in ms after the call that queues the frame, at most 32767; 0 for no deadline (the default)
+   */
+  void setDeadline(uint16_t ms);
 
-class DFRobot_Lcd_UART: public DFRobot_LcdDisplay
-{
-public:
   /**
-   * @fn DFRobot_Lcd_UART
-   * @brief constructor
-   * @return None
+   * @fn queueDepth
+   * @brief Get the number of frames waiting in the asynchronous queue
+   * @return Number of frames not yet completely sent
    */
-  DFRobot_Lcd_UART(Stream& s);
+  uint16_t queueDepth();
+
   /**
-   * @fn begin
-   * @brief Initialize the function to initialize the UART controller and turn on the screen backlight
-   * @param s Passing a UART object
-   * @return Boolean type, initialized state
-   * @retval true succeed
-   * @retval false failed
+   * @fn getDroppedCount
+   * @brief Get the number of frames discarded because the queue was full (eQueueDrop policy)
+   * @return Number of discarded frames
    */
-  bool begin();
+  uint32_t getDroppedCount();
+#endif
 
-private:
-  Stream* _s;
-  void writeCommand(uint8_t* pBuf, uint16_t len);
-  void readACK(uint8_t* pBuf, uint16_t len);
-};
+  /**
+   * @fn getCoalescedCount
+   * @brief Get the number of frames that were never sent because a newer frame for the same object
+   * @n replaced them in the batch buffer or the asynchronous queue
+   * @return Number of writes saved
+   */
+  uint32_t getCoalescedCount();
+
+#if !LCD_DISABLE_SHADOW
+  /**
+   * @fn setShadowCache
+   * @brief Skip update and value calls that would send exactly the frame last sent for the same object
+   * @n The cache keeps a hash of the last frame of up to LCD_SHADOW_CACHE_LEN objects, the least recently
+   * @n added entry is replaced when it is full. Deleting an object or cleanScreen() forgets its entries.
+   * @n Drawing with a library other than this object (or resetting the screen) makes the cache stale:
+   * @n call setShadowCache(true) again to start over.
+   * @param enable true to use the cache, false to send every call (the default)
+   */
+  void setShadowCache(bool enable);
+
+  /**
+   * @fn getShadowHits
+   * @brief Get the number of calls skipped by the shadow cache because nothing had changed
+   * @return Number of skipped calls
+   */
+  uint32_t getShadowHits();
+
+  /**
+   * @fn getShadowMisses
+   * @brief Get the number of calls the shadow cache looked up and let through
+   * @return Number of calls sent
+   */
+  uint32_t getShadowMisses();
+#endif
+
+  /**
+   * @fn replay
+   * @brief Send the frames of a trace written by DFRobot_LcdRecorder to this display
+   * @n Frames are written as recorded, bypassing batching, the asynchronous queues and the shadow cache,
+   * @n and paced by the module's processing time (or acknowledgements with flow control) like any write.
+   * @param trace Stream to read the trace from, e.g. a file on an SD card
+   * @param realTime true to keep the recorded gaps between frames, false to send as fast as the module allows
+   * @return Number of frames sent; replay stops at the end of the trace or at the first truncated or malformed
+   * @n record, after which getLastError() reports eLcdBadTrace
+   */
+  uint32_t replay(Stream& trace, bool realTime = false);
+
+  /**
+   * @fn getLastError
+   * @brief Get the last error and clear it
+   * @n The library never prints, failures are reported here and through the return values.
+   * @return sLcdError_t, eLcdOK if nothing went wrong since the last call
+   */
+  sLcdError_t getLastError();
+
+#if LCD_ENABLE_STATS
+  /**
+   * @fn getStats
+   * @brief Get the counters of the write path, only available with LCD_ENABLE_STATS
+   * @return The counters since begin or the last resetStats()
+   */
+  const sLcdStats_t& getStats() { return _stats; }
+
+  /**
+   * @fn resetStats
+   * @brief Set all counters to 0
+   */
+  void resetStats();
+#endif
+
+  /**
+   * @fn setWriteHooks
+   * @brief Call functions before and after every write to the interface, e.g. to profile bus time
+   * @n In blocking mode a write is one writeCommand() plus the settle time, and carries the call site
+   * @n set by LCD_CALL(). In asynchronous mode it is one piece sent by poll(), without call site.
+   * @n The hooks run in the write path, keep them short.
+   * @param pre Called before the write, NULL for none
+   * @param post Called after the write, NULL for none
+   */
+  void setWriteHooks(sLcdWriteHook_t pre, sLcdWriteHook_t post);
+
+  /**
+   * @fn setCallSite
+   * @brief Attribute the following writes to a source location, used by LCD_CALL()
+   * @param file Source file, NULL to clear
+   * @param line Source line
+   */
+  void setCallSite(const char* file, uint16_t line);
+
+protected:
+  /**
+   * Interface of a display, set by the subclass constructor: one bus transaction taken from the start of
+   * pBuf and then from more, returning the bytes sent (0 if the bus failed), and a read that does not wait.
+   * They are plain function pointers rather than virtual functions, so the class has no vtable.
+   */
+  typedef uint16_t (*sLcdWriteFn_t)(DFRobot_LcdDisplay* self, const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen);
+  typedef uint16_t (*sLcdReadFn_t)(DFRobot_LcdDisplay* self, uint8_t* pBuf, uint16_t len);
+
+  /**
+   * @fn DFRobot_LcdDisplay
+   * @brief constructor
+   * @param writeFn Writes one bus transaction
+   * @param readFn Reads what has arrived
+   * @return None
+   */
+  DFRobot_LcdDisplay(sLcdWriteFn_t writeFn, sLcdReadFn_t readFn) : _writeFn(writeFn), _readFn(readFn) {}
+
+  /**
+   * @fn waitReady
+   * @brief Give the module time to process the bytes just written
+   * @n Polls pollACK() until it succeeds or the acknowledgement timeout expires when flow control is on,
+   * @n otherwise sleeps LCD_SETTLE_TIME_MS.
+   */
+  void waitReady();
+
+  bool _flowControl = false;
+  uint16_t _ackTimeout = LCD_ACK_TIMEOUT_MS;
+  uint8_t _rxBuf[LCD_RESPONSE_BUF_LEN];
+  uint16_t _rxLen = 0;      // bytes of the response frame collected so far
+#if LCD_ENABLE_STATS
+  sLcdStats_t _stats = {};
+
+  /**
+   * @fn statChunk
+   * @brief Count a piece of len bytes handed to the interface in the given number of bus transactions
+   */
+  void statChunk(uint16_t len, uint8_t transactions)
+  {
+    _stats.bytes += len;
+    _stats.chunks++;
+    _stats.transactions += transactions;
+  }
+  void statFrame(uint8_t cmd);
+  void statFrames(const uint8_t* pBuf, uint16_t len);
+  void statBlocked(unsigned long us);
+#endif
+
+private:
+  sLcdWriteFn_t _writeFn;
+  sLcdReadFn_t _readFn;
+  uint8_t _idMap[LCD_OBJECT_TYPE_NUM][LCD_ID_MAP_LEN] = {};   // bit n set: ID n + 1 is in use
+  bool _batching = false;   // the mode flags stay in every build, they are just never set when a mode is left out
+  bool _async = false;
+  bool _shadowing = false;
+#if !LCD_DISABLE_BATCH
+  uint8_t _batchBuf[LCD_BATCH_BUF_LEN];
+  uint16_t _batchLen = 0;
+#endif
+#if !LCD_DISABLE_ASYNC
+  uint8_t _txRing[LCD_ASYNC_BUF_LEN];
+  uint8_t _liveRing[LCD_ASYNC_LIVE_BUF_LEN];
+  sLcdQueue_t _txQueue = {_txRing, LCD_ASYNC_BUF_LEN, 0, 0, 0, 0, 0};
+  sLcdQueue_t _liveQueue = {_liveRing, LCD_ASYNC_LIVE_BUF_LEN, 0, 0, 0, 0, 0};
+  uint16_t _deadline = 0;
+  unsigned long _txReadyAt = 0;
+  bool _txAckWait = false;
+  sLcdQueuePolicy_t _queuePolicy = eQueueBlock;
+  uint32_t _txDropped = 0;
+#endif
+  uint32_t _coalesced = 0;
+  sLcdError_t _lastError = eLcdOK;
+#if !LCD_DISABLE_SHADOW
+  sShadowEntry_t _shadow[LCD_SHADOW_CACHE_LEN];
+  uint8_t _shadowNext = 0;
+  uint32_t _shadowHits = 0;
+  uint32_t _shadowMisses = 0;
+#endif
+  sLcdWriteHook_t _preWrite = NULL;
+  sLcdWriteHook_t _postWrite = NULL;
+  const char* _callFile = NULL;
+  uint16_t _callLine = 0;
+
+  /**
+   * @struct sLcdText_t
+   * @brief Text handed to an encoder: where it is, how long, and whether it lives in program memory
+   */
+  typedef struct {
+    const char* str;
+    uint16_t len;
+    bool flash;     // str points to program memory (F(), PROGMEM) and is read with memcpy_P()
+  } sLcdText_t;
+
+  void setBackgroundImg(uint8_t location, const sLcdText_t& text);
+#if !LCD_DISABLE_EXTERNAL_ICON
+  uint8_t drawIcon(int16_t x, int16_t y, const sLcdText_t& text, uint16_t zoom);
+  void updateIcon(uint8_t iconId, int16_t x, int16_t y, const sLcdText_t& text, uint16_t zoom);
+#endif
+#if !LCD_DISABLE_GIF
+  uint8_t drawGif(int16_t x, int16_t y, const sLcdText_t& text, uint16_t zoom);
+#endif
+#if !LCD_DISABLE_CHART
+  uint8_t creatChart(const sLcdText_t& textX, const sLcdText_t& textY, uint32_t bgColor, uint8_t type);
+  uint8_t setChartAxisTexts(uint8_t chartId, uint8_t axis, const sLcdText_t& text, uint16_t settle = 0);
+#endif
+#if !LCD_DISABLE_TEXT
+  uint8_t drawString(uint16_t x, uint16_t y, const sLcdText_t& text, uint8_t fontSize, uint32_t color);
+  void updateString(uint8_t id, uint16_t x, uint16_t y, const sLcdText_t& text, uint8_t fontSize, uint32_t color);
+#endif
+
+  /**
+   * @fn getID
+   * @brief Allocate the lowest free ID for an object type
+   * @param type Draw command of the object type
+   * @return The ID, 0 if every ID of this type is in use (getLastError() then reports eLcdNoFreeID)
+   */
+  uint8_t getID(uint8_t type);
+
+  /**
+   * @fn freeID
+   * @brief Return an ID to its object type so it can be handed out again
+   * @param type Draw command of the object type
+   * @param id The ID
+   */
+  void freeID(uint8_t type, uint8_t id);
+
+  /**
+   * @fn objectIndex
+   * @brief Row of _idMap for an object type
+   * @param type Draw command of the object type
+   * @return Row index, -1 if the command does not create objects
+   */
+  static int8_t objectIndex(uint8_t type);
+
+  /**
+   * @fn creatCommand
+   * @brief Fill in the frame header (0x55 0xAA len cmd) of a caller-provided buffer and clear its payload
+   * @param pBuf Frame buffer, at least len bytes, usually on the caller's stack
+   * @param cmd Command code
+   * @param len Total frame length, including the header
+   */
+  void creatCommand(uint8_t* pBuf, uint8_t cmd, uint8_t len);
+
+  /**
+   * @fn sendCommand
+   * @brief Hand a finished frame to the interface, or append it to the batch buffer while batching
+   * @param pBuf Frame
+   * @param len Frame length
+   * @param settle Extra time in ms the screen needs after this frame before it accepts the next one
+   */
+  void sendCommand(uint8_t* pBuf, uint16_t len, uint16_t settle = 0);
+
+  /**
+   * @fn sendFields
+   * @brief Encode a fixed-length frame from its field layout and send it
+   * @n Each field is written big-endian with the width the layout gives it; bytes after the last field stay 0.
+   * @param cmd Command code
+   * @param len Total frame length, at most LCD_FIELDS_FRAME_MAX_LEN
+   * @param layout Field widths from lcdLayout()
+   * @param fields Field values in frame order
+   * @param settle Extra time in ms the screen needs after this frame
+   */
+  void sendFields(uint8_t cmd, uint8_t len, uint32_t layout, const uint32_t* fields, uint16_t settle = 0);
+
+  /**
+   * @fn sendText
+   * @brief Encode a frame of fixed fields followed by text and send it
+   * @n The text is cut to what fits into LCD_FRAME_MAX_LEN. In blocking mode, without batching and
+   * @n shadow cache, it is written from where it is through writeGather(); otherwise it is copied once
+   * @n behind the header, since the batch buffer, the queue and the cache keep whole frames.
+   * @param cmd Command code
+   * @param layout Field widths from lcdLayout()
+   * @param fields Field values in frame order
+   * @param text Text after the fields
+   * @param settle Extra time in ms the screen needs after this frame
+   */
+  void sendText(uint8_t cmd, uint32_t layout, const uint32_t* fields, const sLcdText_t& text, uint16_t settle = 0);
+
+  /**
+   * @fn sendJoined
+   * @brief Copy header and text into one frame and pass it to sendCommand(); kept apart from sendText()
+   * @n so that the frame buffer is only on the stack when it is needed
+   * @param len Bytes of the text to copy
+   */
+  void sendJoined(const uint8_t* head, uint8_t headLen, const sLcdText_t& text, uint16_t len, uint16_t settle);
+
+  /**
+   * @fn sendFormatted
+   * @brief Encode a frame of fixed fields followed by printf() output and send it, formatting into the frame itself
+   * @param cmd Command code
+   * @param layout Field widths from lcdLayout()
+   * @param fields Field values in frame order
+   * @param format printf() format
+   * @param flash true if format is in program memory
+   * @param args Arguments of the format
+   */
+  void sendFormatted(uint8_t cmd, uint32_t layout, const uint32_t* fields, const char* format, bool flash, va_list args);
+
+  /**
+   * @fn packFields
+   * @brief Write fields big-endian from byte 4 of a frame on, with the widths a layout gives them
+   */
+  static void packFields(uint8_t* pBuf, uint32_t layout, const uint32_t* fields);
+
+  /**
+   * @fn transmit
+   * @brief Write one or more frames now, or put them into the asynchronous queue
+   * @param pBuf Frames
+   * @param len Total length
+   * @param settle Extra time in ms the screen needs after the last frame
+   */
+  void transmit(uint8_t* pBuf, uint16_t len, uint16_t settle);
+
+  /**
+   * @fn transmitGather
+   * @brief Write one frame held as header and payload now, in blocking mode without batching
+   * @param head Frame header and fixed fields
+   * @param headLen Length of head
+   * @param payload Rest of the frame
+   * @param payloadLen Length of payload
+   * @param settle Extra time in ms the screen needs after the frame
+   */
+  void transmitGather(const uint8_t* head, uint8_t headLen, const uint8_t* payload, uint16_t payloadLen, uint16_t settle);
+
+  /**
+   * @fn preWrite
+   * @brief Fill in a write event for the frame at pBuf and call the pre-write hook
+   * @param event Event to fill in
+   * @param pBuf Frame, or its first six bytes
+   * @param len Bytes about to be written
+   */
+  void preWrite(sLcdWriteEvent_t* event, const uint8_t* pBuf, uint16_t len);
+
+  /**
+   * @fn postWrite
+   * @brief Complete a write event and call the post-write hook
+   */
+  void postWrite(sLcdWriteEvent_t* event);
+
+#if !LCD_DISABLE_BATCH
+  bool coalesceBatch(uint8_t* pBuf, uint16_t len);
+#endif
+#if !LCD_DISABLE_ASYNC
+  bool enqueueCommand(uint8_t* pBuf, uint16_t len, uint16_t settle);
+  bool coalesceCommand(sLcdQueue_t* queue, uint8_t* pBuf, uint16_t len);
+  uint16_t peekQueue(sLcdQueue_t* queue, uint8_t* pBuf, uint16_t maxLen);
+  uint8_t consumeQueue(sLcdQueue_t* queue, uint16_t len);
+  void drainQueue();
+
+  /**
+   * @fn sendQueued
+   * @brief The work of poll(), also used while waiting for the queues to drain
+   */
+  void sendQueued();
+  uint16_t ringIndex(sLcdQueue_t* queue, uint16_t pos);
+  uint16_t queueFrameLen(sLcdQueue_t* queue, uint16_t pos);
+
+  /**
+   * @fn queueMentions
+   * @brief Whether a queued frame creates, changes, deletes or raises the object of a value frame, or clears the screen
+   * @n The value must then stay behind it instead of overtaking it in the live queue.
+   * @param queue Queue to search
+   * @param pBuf Value frame
+   */
+  bool queueMentions(sLcdQueue_t* queue, uint8_t* pBuf);
+
+  /**
+   * @fn queueExpired
+   * @brief Whether the queued frame at pos has a deadline (see setDeadline()) that has passed
+   */
+  bool queueExpired(sLcdQueue_t* queue, uint16_t pos);
+
+  /**
+   * @fn dropExpired
+   * @brief Discard overdue frames from the front of the layout queue, counting them as dropped
+   */
+  void dropExpired();
+#endif
+
+  /**
+   * @fn frameKeyLen
+   * @brief Number of bytes, starting at the command byte, that identify which object a frame is about
+   * @param cmd Command code
+   * @return Key length, 0 if frames of this command must never replace each other
+   */
+  static uint8_t frameKeyLen(uint8_t cmd);
+
+  /**
+   * @fn objectType
+   * @brief Fold the external (image path) draw commands of icons and GIFs onto the internal ones
+   * @n Both variants draw the same object, which delete and angle frames name by the internal code.
+   * @param cmd Command code
+   * @return CMD_OF_DRAW_ICON_INTERNAL or CMD_OF_DRAW_GIF_INTERNAL for either variant, otherwise cmd
+   */
+  static uint8_t objectType(uint8_t cmd);
+
+  /**
+   * @fn isValueCommand
+   * @brief Whether a command only sets the value of an existing object, so that a later one makes it obsolete
+   * @param cmd Command code
+   * @return true for the value setters of bars, sliders, gauges, line meters, compasses and rotating icons
+   */
+  static bool isValueCommand(uint8_t cmd);
+
+#if !LCD_DISABLE_SHADOW
+  /**
+   * @fn shadowHit
+   * @brief Look a frame up in the shadow cache and remember it
+   * @param pBuf Frame
+   * @param len Frame length
+   * @return true if the same frame was the last one sent for this object, so it can be skipped
+   */
+  bool shadowHit(uint8_t* pBuf, uint16_t len);
+
+  /**
+   * @fn shadowForget
+   * @brief Remove the shadow cache entries of an object
+   * @param pBuf Frame whose object is forgotten: a delete frame, or any frame shadowHit() accepted
+   */
+  void shadowForget(uint8_t* pBuf);
+#endif
+
+  /**
+   * @fn parseResponse
+   * @brief Feed the response parser with the bytes the interface has ready, without blocking
+   * @n Bytes before a 0x55 0xAA header are skipped; a frame split over several reads is
+   * @n collected in _rxBuf across calls.
+   * @param headerOnly Stop as soon as the header has arrived instead of reading the whole frame
+   * @return true once the header (headerOnly) or the complete frame has been received
+   */
+  bool parseResponse(bool headerOnly);
+
+  /**
+   * @fn readACK
+   * @brief Wait for a complete response frame from the module
+   * @param pBuf Receives the frame, including its header; may be NULL to just discard it
+   * @param len Size of pBuf, longer frames are truncated
+   * @param timeout Longest wait in ms, 0 to only look at what has already arrived
+   * @return Number of bytes copied to pBuf, 0 if no complete frame arrived in time
+   * @n A partial frame is kept and completed by the next call.
+   */
+  uint16_t readACK(uint8_t* pBuf, uint16_t len, uint16_t timeout = LCD_ACK_TIMEOUT_MS);
+
+  /**
+   * @fn pollACK
+   * @brief Check once, without blocking, whether the module has acknowledged the last write
+   * @return true if an acknowledgement (a frame starting with 0x55 0xAA) was received
+   */
+  bool pollACK();
+
+  /**
+   * @fn writeCommand
+   * @brief Write a frame (or several) in as many bus transactions as the interface needs, waiting for the screen after each
+   */
+  void writeCommand(uint8_t* pBuf, uint16_t len) { writeGather(pBuf, len, NULL, 0); }
+
+  /**
+   * @fn readChunk
+   * @brief Read what the module has to say, without waiting for more
+   * @param pBuf Receives the data
+   * @param len Most bytes wanted
+   * @return Number of bytes actually read, 0 if there is nothing to read
+   */
+  uint16_t readChunk(uint8_t* pBuf, uint16_t len) { return _readFn(this, pBuf, len); }
+
+  /**
+   * @fn writeChunk
+   * @brief Start one bus transaction with the beginning of pBuf, without waiting for the screen afterwards
+   * @param pBuf Data to send
+   * @param len Length of the data
+   * @return Number of bytes actually sent, at most len
+   */
+  uint16_t writeChunk(const uint8_t* pBuf, uint16_t len) { return _writeFn(this, pBuf, len, NULL, 0); }
+
+  /**
+   * @fn writeGather
+   * @brief Write one frame that is held in two pieces, as writeCommand() would write it in one
+   * @n The transaction across the joint takes from both pieces, so long texts are never copied and a
+   * @n short frame is still a single transaction.
+   * @param head Frame header and fixed fields
+   * @param headLen Length of head
+   * @param payload Rest of the frame, e.g. the caller's text
+   * @param payloadLen Length of payload
+   */
+  void writeGather(const uint8_t* head, uint16_t headLen, const uint8_t* payload, uint16_t payloadLen);
+};
+
+
+#ifdef ARDUINO
+class DFRobot_Lcd_IIC: public DFRobot_LcdDisplay
+{
+public:
+  /**
+   * @fn DFRobot_Lcd_IIC
+   * @brief constructor
+   * @param pWire I2C controller object
+   * @param addr I2C address. The default value is 0x2c
+   * @param chunkSize Largest number of bytes per I2C transaction, must not exceed the Wire buffer of the core.
+   * @n The default is detected from the core at compile time (32 bytes on AVR).
+   * @return None
+   */
+  DFRobot_Lcd_IIC(TwoWire* pWire = &Wire, uint8_t addr = 0x2c, uint16_t chunkSize = LCD_I2C_CHUNK_SIZE);
+
+  /**
+   * @fn begin
+   * @brief Initialize the function to initialize the I2C controller and turn on the screen backlight
+   * @param clock I2C clock in Hz, 100 kHz by default. The module runs fine at 400 kHz.
+   * @n Pass LCD_I2C_CLOCK_AUTO to pick the fastest rate the module acknowledges with probeClock().
+   * @return Boolean type, initialized state
+   * @retval true succeed
+   * @retval false failed
+   */
+  bool begin(uint32_t clock = LCD_I2C_CLOCK_DEFAULT);
+
+  /**
+   * @fn probeClock
+   * @brief Step the I2C clock up through 100 kHz, 400 kHz and 1 MHz and keep the fastest one
+   * @n that the module acknowledges LCD_I2C_PROBE_TRIES times in a row
+   * @param maxClock Highest clock to try, in Hz
+   * @return The chosen clock in Hz, 0 if the module does not answer even at 100 kHz
+   */
+  uint32_t probeClock(uint32_t maxClock = 1000000);
+
+  /**
+   * @fn getClock
+   * @brief Get the I2C clock set by begin() or probeClock()
+   * @return I2C clock in Hz
+   */
+  uint32_t getClock();
+
+  /**
+   * @fn addMirror
+   * @brief Also send everything to the module at another I2C address on the same bus
+   * @n Frames are encoded once and each bus transaction is repeated for every mirror, so all modules
+   * @n show the same content and process it in parallel. Acknowledgements and responses are only read
+   * @n from the main address.
+   * @param addr I2C address of the mirror module
+   * @return true if the module answered and was added, false if it is absent or LCD_I2C_MAX_MIRRORS are in use
+   */
+  bool addMirror(uint8_t addr);
+
+private:
+  uint8_t _deviceAddr;
+  uint16_t _chunkSize;
+  uint32_t _clock;
+  TwoWire* _pWire;
+  uint8_t _mirrorAddr[LCD_I2C_MAX_MIRRORS];
+  uint8_t _mirrorNum = 0;
+
+  /**
+   * @fn writePieces
+   * @brief Send one transaction of up to _chunkSize bytes, taken from pBuf and then from more
+   * @return Number of bytes sent
+   */
+  static uint16_t writePieces(DFRobot_LcdDisplay* self, const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen);
+  static uint16_t readPieces(DFRobot_LcdDisplay* self, uint8_t* pBuf, uint16_t len);
+};
+#endif
+
+class DFRobot_Lcd_UART: public DFRobot_LcdDisplay
+{
+public:
+  /**
+   * @fn DFRobot_Lcd_UART
+   * @brief constructor
+   * @return None
+   */
+  DFRobot_Lcd_UART(Stream& s);
+  /**
+   * @fn begin
+   * @brief Initialize the function to initialize the UART controller and turn on the screen backlight
+   * @param s Passing a UART object
+   * @return Boolean type, initialized state
+   * @retval true succeed
+   * @retval false failed
+   */
+  bool begin();
+
+private:
+  Stream* _s;
+
+  /**
+   * @fn writePieces
+   * @brief Write pBuf and then more to the port, as one chunk
+   * @return Number of bytes written
+   */
+  static uint16_t writePieces(DFRobot_LcdDisplay* self, const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen);
+  static uint16_t readPieces(DFRobot_LcdDisplay* self, uint8_t* pBuf, uint16_t len);
+};
+
+#ifdef ARDUINO
+/**
+ * @brief I2C transport for DFRobot_LcdDisplayT
+ * @n A transport is any class with these four members; write your own to drive the module over another bus.
+ */
+class DFRobot_LcdWireTransport
+{
+public:
+  /**
+   * @fn DFRobot_LcdWireTransport
+   * @brief constructor
+   * @param pWire I2C controller object
+   * @param addr I2C address. The default value is 0x2c
+   * @param chunkSize Largest number of bytes per I2C transaction, must not exceed the Wire buffer of the core
+   */
+  DFRobot_LcdWireTransport(TwoWire* pWire = &Wire, uint8_t addr = 0x2c, uint16_t chunkSize = LCD_I2C_CHUNK_SIZE);
+
+  /**
+   * @fn begin
+   * @brief Initialize the bus and check that the module answers
+   * @return true if the module acknowledged its address
+   */
+  bool begin();
+
+  /**
+   * @fn write
+   * @brief Send the beginning of pBuf in one bus transaction
+   * @param pBuf Data to send
+   * @param len Length of the data
+   * @return Number of bytes actually sent, at most len; 0 if the bus failed, the rest of the frame is then dropped
+   */
+  uint16_t write(const uint8_t* pBuf, uint16_t len);
+
+  /**
+   * @fn write
+   * @brief Send the beginning of pBuf and then of more in one bus transaction
+   * @n Optional for a transport: with it a frame whose text is held apart from its header
+   * @n still goes out in the transactions it would take in one buffer, without being copied.
+   * @param pBuf First piece
+   * @param len Length of the first piece
+   * @param more Second piece
+   * @param moreLen Length of the second piece
+   * @return Number of bytes actually sent, at most len + moreLen; 0 if the bus failed
+   */
+  uint16_t write(const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen);
+
+  /**
+   * @fn read
+   * @brief Read what the module has to say, without waiting for more
+   * @param pBuf Receives the data
+   * @param len Most bytes wanted
+   * @return Number of bytes actually read
+   */
+  uint16_t read(uint8_t* pBuf, uint16_t len);
+
+  /**
+   * @fn discard
+   * @brief Throw away input that has arrived but was not read yet
+   */
+  void discard() {}
+
+private:
+  TwoWire* _pWire;
+  uint8_t _deviceAddr;
+  uint16_t _chunkSize;
+};
+#endif
+
+/**
+ * @brief UART (or any Stream) transport for DFRobot_LcdDisplayT
+ */
+class DFRobot_LcdStreamTransport
+{
+public:
+  /**
+   * @fn DFRobot_LcdStreamTransport
+   * @brief constructor
+   * @param s The serial port the module is connected to
+   */
+  DFRobot_LcdStreamTransport(Stream& s);
+  bool begin();
+  uint16_t write(const uint8_t* pBuf, uint16_t len);
+  uint16_t write(const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen);
+  uint16_t read(uint8_t* pBuf, uint16_t len);
+  void discard();
+
+private:
+  Stream* _s;
+};
+
+/**
+ * @fn lcdTransportWrite
+ * @brief Send pBuf and then more in one write() of a transport
+ * @n Uses the transport's write(pBuf, len, more, moreLen) when it has one; otherwise the two pieces,
+ * @n which are always parts of one frame, are joined in a frame on the stack first.
+ * @return What the transport's write returned
+ */
+template <class Transport>
+inline auto lcdTransportWrite(Transport& transport, const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen, int)
+  -> decltype(transport.write(pBuf, len, more, moreLen))
+{
+  return transport.write(pBuf, len, more, moreLen);
+}
+
+template <class Transport>
+inline uint16_t lcdTransportWrite(Transport& transport, const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen, long)
+{
+  uint8_t frame[LCD_FRAME_MAX_LEN];
+  memcpy(frame, pBuf, len);
+  memcpy(frame + len, more, moreLen);
+  return transport.write(frame, len + moreLen);
+}
+
+template <class Transport>
+inline uint16_t lcdTransportWrite(Transport& transport, const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen)
+{
+  if (moreLen == 0) {
+    return transport.write(pBuf, len);
+  }
+  return lcdTransportWrite(transport, pBuf, len, more, moreLen, 0);
+}
+
+/**
+ * @brief Display whose interface is chosen at compile time
+ * @n DFRobot_Lcd_IIC and DFRobot_Lcd_UART pick the interface by subclassing. Here it is a template
+ * @n parameter instead, so the transport calls are resolved at compile time and inlined into the
+ * @n write function the display hands to DFRobot_LcdDisplay. Text is sent from where it is: a
+ * @n transport with write(pBuf, len, more, moreLen) sends header and text in one transaction, the
+ * @n others get them joined on the stack.
+ * @n Transport needs begin(), write(), read() and discard() as in DFRobot_LcdWireTransport.
+ * @n Example: DFRobot_LcdDisplayT<DFRobot_LcdWireTransport> lcd(DFRobot_LcdWireTransport(&Wire, 0x2c));
+ */
+template <class Transport>
+class DFRobot_LcdDisplayT: public DFRobot_LcdDisplay
+{
+public:
+  /**
+   * @fn DFRobot_LcdDisplayT
+   * @brief constructor
+   * @param transport The transport, copied into the display
+   * @return None
+   */
+  explicit DFRobot_LcdDisplayT(const Transport& transport = Transport())
+    : DFRobot_LcdDisplay(writePieces, readPieces), _transport(transport) {}
+
+  /**
+   * @fn begin
+   * @brief Initialize the transport
+   * @return Boolean type, initialized state
+   * @retval true succeed
+   * @retval false failed
+   */
+  bool begin() { return _transport.begin(); }
+
+  /**
+   * @fn transport
+   * @brief Access the transport, e.g. to change its settings
+   * @return The transport
+   */
+  Transport& transport() { return _transport; }
+
+private:
+  Transport _transport;
+
+  static uint16_t writePieces(DFRobot_LcdDisplay* self, const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen)
+  {
+    DFRobot_LcdDisplayT* lcd = static_cast<DFRobot_LcdDisplayT*>(self);
+    if (lcd->_flowControl) {
+      // Drop late acknowledgements of earlier writes so they are not taken for this one
+      lcd->_transport.discard();
+      lcd->_rxLen = 0;
+    }
+    uint16_t sent = lcdTransportWrite(lcd->_transport, pBuf, len, more, moreLen);
+    LCD_STAT(if (sent == 0) lcd->_stats.failedTransactions++);
+    LCD_STAT(lcd->statChunk(sent, 1));
+    return sent;
+  }
+
+  static uint16_t readPieces(DFRobot_LcdDisplay* self, uint8_t* pBuf, uint16_t len)
+  {
+    return static_cast<DFRobot_LcdDisplayT*>(self)->_transport.read(pBuf, len);
+  }
+};
+
+/**
+ * @brief Transport decorator that records every frame it writes
+ * @n Wraps another transport and appends each frame passing through it to a binary trace:
+ * @n a LCD_TRACE_STAMP_LEN byte little-endian micros() timestamp, taken when the first byte of the frame
+ * @n is written, followed by the frame itself (0x55 0xAA len cmd payload). Frames split over several
+ * @n writes are recorded once. Play a trace back with DFRobot_LcdDisplay::replay().
+ * @n The trace is written inline, so use a fast Print (a file, a large buffer) to not distort the timing.
+ * @n Example: DFRobot_LcdDisplayT<DFRobot_LcdRecorder<DFRobot_LcdWireTransport> > lcd(DFRobot_LcdRecorder<DFRobot_LcdWireTransport>(file));
+ */
+template <class Transport>
+class DFRobot_LcdRecorder
+{
+public:
+  /**
+   * @fn DFRobot_LcdRecorder
+   * @brief constructor
+   * @param trace Where the trace is written
+   * @param transport The transport that actually talks to the module, copied into the recorder
+   */
+  DFRobot_LcdRecorder(Print& trace, const Transport& transport = Transport()) : _transport(transport), _trace(&trace) {}
+
+  bool begin() { return _transport.begin(); }
+
+  uint16_t write(const uint8_t* pBuf, uint16_t len)
+  {
+    uint16_t sent = _transport.write(pBuf, len);
+    record(pBuf, sent);
+    return sent;
+  }
+
+  uint16_t write(const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen)
+  {
+    uint16_t sent = lcdTransportWrite(_transport, pBuf, len, more, moreLen);
+    if (sent > len) {
+      record(pBuf, len);
+      record(more, sent - len);
+    } else {
+      record(pBuf, sent);
+    }
+    return sent;
+  }
+
+  uint16_t read(uint8_t* pBuf, uint16_t len) { return _transport.read(pBuf, len); }
+
+  void discard() { _transport.discard(); }
+
+  /**
+   * @fn getFrameCount
+   * @brief Get the number of frames recorded so far
+   * @return Number of frames
+   */
+  uint32_t getFrameCount() { return _frames; }
+
+  /**
+   * @fn transport
+   * @brief Access the wrapped transport
+   * @return The transport
+   */
+  Transport& transport() { return _transport; }
+
+private:
+  Transport _transport;
+  Print* _trace;
+  uint8_t _head[CMDLEN_OF_HEAD_LEN];
+  uint8_t _headLen = 0;     // bytes of the current frame header seen so far
+  uint8_t _remaining = 0;   // bytes of the current frame after its header still to come
+  uint32_t _stamp = 0;
+  uint32_t _frames = 0;
+
+  void record(const uint8_t* pBuf, uint16_t len)
+  {
+    uint16_t i = 0;
+    while (i < len) {
+      if (_remaining) {
+        uint16_t n = (len - i < _remaining) ? (len - i) : _remaining;
+        _trace->write(pBuf + i, n);
+        _remaining -= n;
+        i += n;
+        continue;
+      }
+      uint8_t data = pBuf[i++];
+      if (_headLen == 0) {
+        if (data != CMD_HEADER_HIGH) {
+          continue;
+        }
+        _stamp = micros();
+      } else if ((_headLen == 1) && (data != CMD_HEADER_LOW)) {
+        _headLen = 0;
+        continue;
+      }
+      _head[_headLen++] = data;
+      if (_headLen == CMDLEN_OF_HEAD_LEN) {
+        for (uint8_t b = 0; b < LCD_TRACE_STAMP_LEN; b++) {
+          _trace->write((uint8_t)(_stamp >> (8 * b)));
+        }
+        _trace->write(_head, CMDLEN_OF_HEAD_LEN);
+        _remaining = _head[2];
+        _headLen = 0;
+        _frames++;
+      }
+    }
+  }
+};
+
+/**
+ * @brief Attributes the writes of one API call to the line that makes it, see LCD_CALL()
+ * @n Lives until the end of the statement and clears the call site again then.
+ */
+class DFRobot_LcdCallSite
+{
+public:
+  DFRobot_LcdCallSite(DFRobot_LcdDisplay& lcd, const char* file, uint16_t line) : _lcd(&lcd)
+  {
+    _lcd->setCallSite(file, line);
+  }
+  ~DFRobot_LcdCallSite()
+  {
+    _lcd->setCallSite(NULL, 0);
+  }
+  DFRobot_LcdDisplay* operator->() { return _lcd; }
+
+private:
+  DFRobot_LcdDisplay* _lcd;
+};
+
+/**
+ * Make an API call whose writes report this source line to the write hooks (see setWriteHooks()):
+ * LCD_CALL(lcd)->updateString(id, 10, 10, text, 0, WHITE);
+ */
+#define LCD_CALL(lcd)   DFRobot_LcdCallSite((lcd), __FILE__, __LINE__)
+
+#if !LCD_DISABLE_ASYNC
+class DFRobot_LcdGroup
+{
+public:
+  /**
+   * @fn DFRobot_LcdGroup
+   * @brief constructor
+   * @return None
+   */
+  DFRobot_LcdGroup();
+
+  /**
+   * @fn add
+   * @brief Put a display under the group's scheduler and switch it to asynchronous mode
+   * @n Drawing calls on the display then only queue frames; the group's poll() sends them.
+   * @param lcd The display, already initialized with begin()
+   * @param policy What the display does when its queue is full (see setAsync())
+   * @return true if added, false if LCD_GROUP_MAX_DISPLAYS are already in the group
+   */
+  bool add(DFRobot_LcdDisplay& lcd, DFRobot_LcdDisplay::sLcdQueuePolicy_t policy = DFRobot_LcdDisplay::eQueueBlock);
+
+  /**
+   * @fn poll
+   * @brief Give every display in the group one chance to send, call it from loop()
+   * @n Displays are visited round robin, starting one further each call. A display that is still
+   * @n processing its last write returns at once, so its processing time is spent sending to the others.
+   */
+  void poll();
+
+  /**
+   * @fn queueDepth
+   * @brief Get the number of frames waiting in all queues of the group
+   * @return Number of frames not yet completely sent
+   */
+  uint16_t queueDepth();
+
+  /**
+   * @fn flush
+   * @brief Run poll() until every display of the group has sent all its frames
+   */
+  void flush();
+
+private:
+  DFRobot_LcdDisplay* _displays[LCD_GROUP_MAX_DISPLAYS];
+  uint8_t _num;
+  uint8_t _next;
+};
+#endif
+
+#if !LCD_DISABLE_TEXT
+/**
+ * @brief Time and date on the screen, kept as separate text objects so that tick() resends only what changed
+ * @n Hours, minutes and seconds are one 2-character text object each with fixed colons between them,
+ * @n so a tick normally sends one short frame for the seconds. The date is one more object, redrawn once a day.
+ */
+class DFRobot_LcdClock
+{
+public:
+  /**
+   * @struct sLcdClockTime_t
+   * @brief Calendar time
+   */
+  typedef struct {
+    uint16_t year;
+    uint8_t month;      /**<1 to 12 */
+    uint8_t day;        /**<1 to 31 */
+    uint8_t weekday;    /**<1 (Monday) to 7 (Sunday), as for drawLcdDate() */
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+  }sLcdClockTime_t;
+
+  /**
+   * @brief Time source, e.g. a function that reads an RTC chip and fills in the time
+   */
+  typedef void (*sLcdClockSource_t)(sLcdClockTime_t* time);
+
+  /**
+   * @fn DFRobot_LcdClock
+   * @brief constructor, the clock starts at 2000-01-01 00:00:00 and counts with millis()
+   * @param lcd The display to draw on, already initialized with begin()
+   */
+  DFRobot_LcdClock(DFRobot_LcdDisplay& lcd);
+
+  /**
+   * @fn setTime
+   * @brief Set the time of day the millis() clock counts from
+   * @param hour 0 to 23
+   * @param minute 0 to 59
+   * @param second 0 to 59
+   */
+  void setTime(uint8_t hour, uint8_t minute, uint8_t second);
+
+  /**
+   * @fn setDate
+   * @brief Set the date the millis() clock counts from; it rolls over months, years and leap days by itself
+   * @param year Year, e.g. 2024
+   * @param month 1 to 12
+   * @param day 1 to 31
+   * @param weekday 1 (Monday) to 7 (Sunday)
+   */
+  void setDate(uint16_t year, uint8_t month, uint8_t day, uint8_t weekday);
+
+  /**
+   * @fn setTimeSource
+   * @brief Take the time from a callback, e.g. one reading an RTC, instead of counting with millis()
+   * @param source Called by tick() for the current time, NULL to count on with millis() from the last time read
+   */
+  void setTimeSource(sLcdClockSource_t source);
+
+  /**
+   * @fn getTime
+   * @brief Get the time as of the last tick() or draw call
+   * @return Calendar time
+   */
+  const sLcdClockTime_t& getTime() { return _time; }
+
+  /**
+   * @fn drawTime
+   * @brief Display the time as hh:mm:ss, five text objects starting at (x, y)
+   * @n The characters are LCD_CLOCK_CHAR_WIDTH_24PX or LCD_CLOCK_CHAR_WIDTH_12PX pixels apart.
+   * @param x The x-coordinate of the starting position
+   * @param y The y-coordinate of the starting position
+   * @param fontSize Text size: 0 (24px size), 1 (12px size)
+   * @param color Color of text
+   * @return true if drawn, false if the display has no text IDs left
+   */
+  bool drawTime(uint16_t x, uint16_t y, uint8_t fontSize, uint32_t color);
+
+  /**
+   * @fn drawDate
+   * @brief Display the date in the format of drawLcdDate(), one text object at (x, y)
+   * @param x The x-coordinate of the starting position
+   * @param y The y-coordinate of the starting position
+   * @param fontSize Text size: 0 (24px size), 1 (12px size)
+   * @param color Color of text
+   * @return true if drawn, false if the display has no text IDs left
+   */
+  bool drawDate(uint16_t x, uint16_t y, uint8_t fontSize, uint32_t color);
+
+  /**
+   * @fn tick
+   * @brief Read the time and update the fields on the screen that changed, call it from loop()
+   * @n Several changes, e.g. at the full minute, can be packed into one write with beginBatch()/endBatch().
+   * @return Number of frames sent, 0 if nothing changed
+   */
+  uint8_t tick();
+
+  /**
+   * @fn deleteTime
+   * @brief Remove the time from the screen
+   */
+  void deleteTime();
+
+  /**
+   * @fn deleteDate
+   * @brief Remove the date from the screen
+   */
+  void deleteDate();
+
+private:
+  DFRobot_LcdDisplay* _lcd;
+  sLcdClockSource_t _source;
+  sLcdClockTime_t _time;
+  unsigned long _since;     // millis() of the last whole second counted
+  uint8_t _timeIds[5];      // hours, colon, minutes, colon, seconds
+  uint8_t _shown[3];        // hours, minutes and seconds on the screen
+  uint16_t _timeX, _timeY;
+  uint8_t _timeFont, _charWidth;
+  uint32_t _timeColor;
+  uint8_t _dateId;
+  uint16_t _shownDate;      // (month << 5) | day on the screen
+  uint16_t _dateX, _dateY;
+  uint8_t _dateFont;
+  uint32_t _dateColor;
+
+  /**
+   * @fn readTime
+   * @brief Bring _time up to date from the time source or millis()
+   */
+  void readTime();
+
+  /**
+   * @fn sendDate
+   * @brief Draw (id 0) or update the date object
+   * @return Text control handle
+   */
+  uint8_t sendDate(uint8_t id);
+};
+#endif
 
 #endif
\ No newline at end of file
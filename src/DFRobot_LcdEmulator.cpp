@@ -0,0 +1,359 @@
+/*!
+ * @file DFRobot_LcdEmulator.cpp
+ * @brief Software model of the DFR0997 module, used as a transport of DFRobot_LcdDisplayT
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @author [fengli](li.feng@dfrobot.com)
+ * @maintainer [qsjhyy](yihuan.huang@dfrobot.com)
+ * @maintainer [GDuang](yonglei.ren@dfrobot.com)
+ * @version  V2.0
+ * @date  2024-03-20
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "DFRobot_LcdEmulator.h"
+
+DFRobot_LcdEmulator::DFRobot_LcdEmulator(sLcdEmuLink_t link, uint32_t bitRate)
+{
+  _link = link;
+  _bitRate = bitRate ? bitRate : LCD_I2C_CLOCK_DEFAULT;
+  for (uint8_t cmd = 0; cmd < LCD_EMU_CMD_NUM; cmd++) {
+    switch (cmd) {
+      case 0x1D:
+        _processTime[cmd] = 1500000;
+        break;
+      case CMD_SET_BACKGROUND_COLOR:
+      case CMD_SET_BACKGROUND_IMG:
+        _processTime[cmd] = 300000;
+        break;
+      case CMD_OF_DRAW_LINE_CHART:
+        _processTime[cmd] = 100000;
+        break;
+      case CMD_OF_DRAW_PIXEL:
+        _processTime[cmd] = 1000;
+        break;
+      case CMD_OF_DRAW_BAR_VALUE:
+      case CMD_OF_DRAW_SLIDER_VALUE:
+      case CMD_OF_DRAW_COMPASS_VALUE:
+      case CMD_OF_DRAW_LINE_METER_VALUE:
+      case CMD_OF_DRAW_GAUGE_VALUE:
+      case CMD_SET_ANGLE_OBJ:
+        _processTime[cmd] = 2000;
+        break;
+      default:
+        _processTime[cmd] = 10000;
+        break;
+    }
+  }
+  memset(_objects, 0, sizeof(_objects));
+}
+
+bool DFRobot_LcdEmulator::begin()
+{
+  memset(_objects, 0, sizeof(_objects));
+  _frameLen = 0;
+  _linkFreeAt = _busyUntil = micros();
+  _ackCount = _ackOffset = 0;
+  _frames = _bytes = _errors = 0;
+  _lastError = eEmuOK;
+  _wireTime = _busyTime = 0;
+  return true;
+}
+
+void DFRobot_LcdEmulator::setAck(bool enable)
+{
+  _ack = enable;
+}
+
+void DFRobot_LcdEmulator::setProcessTime(uint8_t cmd, uint32_t us)
+{
+  if (cmd < LCD_EMU_CMD_NUM) {
+    _processTime[cmd] = us;
+  }
+}
+
+uint32_t DFRobot_LcdEmulator::wireTime(uint16_t len)
+{
+  uint32_t bits;
+  if (_link == eEmuLinkI2C) {
+    bits = (len + 1UL) * 9 + 2;   // address byte, data bytes, each with its ACK bit, plus start and stop
+  } else {
+    bits = len * 10UL;
+  }
+  return (uint32_t)((uint64_t)bits * 1000000UL / _bitRate);
+}
+
+uint16_t DFRobot_LcdEmulator::write(const uint8_t* pBuf, uint16_t len)
+{
+  unsigned long now = micros();
+  if ((long)(_linkFreeAt - now) < 0) {
+    _linkFreeAt = now;
+  }
+  uint32_t wire = wireTime(len);
+  _linkFreeAt += wire;
+  _wireTime += wire;
+  _bytes += len;
+
+  for (uint16_t i = 0; i < len; i++) {
+    uint8_t data = pBuf[i];
+    if (((_frameLen == 0) && (data != CMD_HEADER_HIGH)) || ((_frameLen == 1) && (data != CMD_HEADER_LOW))) {
+      // Not a frame header, the module skips it
+      _frameLen = 0;
+      continue;
+    }
+    _frame[_frameLen++] = data;
+    if ((_frameLen > 2) && (_frameLen == _frame[2] + CMDLEN_OF_HEAD_LEN)) {
+      execute(_linkFreeAt);
+      _frameLen = 0;
+    }
+  }
+
+  // A real bus returns once the bytes are on the wire
+  while ((long)(micros() - _linkFreeAt) < 0) {
+    yield();
+  }
+  return len;
+}
+
+void DFRobot_LcdEmulator::execute(unsigned long done)
+{
+  _frames++;
+  sLcdEmuError_t error = check();
+  if ((error == eEmuOK) && ((long)(done - _busyUntil) < 0)) {
+    error = eEmuOverrun;
+  }
+  if (error != eEmuOK) {
+    _errors++;
+    _lastError = error;
+  }
+
+  if ((long)(done - _busyUntil) > 0) {
+    _busyUntil = done;
+  }
+  uint32_t busy = (_frame[3] < LCD_EMU_CMD_NUM) ? _processTime[_frame[3]] : 0;
+  _busyUntil += busy;
+  _busyTime += busy;
+
+  if (_ack && (_ackCount < LCD_EMU_ACK_QUEUE_LEN)) {
+    uint8_t i = (_ackHead + _ackCount) % LCD_EMU_ACK_QUEUE_LEN;
+    _ackCmd[i] = _frame[3];
+    _ackAt[i] = _busyUntil;
+    _ackCount++;
+  }
+}
+
+uint16_t DFRobot_LcdEmulator::read(uint8_t* pBuf, uint16_t len)
+{
+  uint16_t got = 0;
+  unsigned long now = micros();
+  while ((got < len) && _ackCount && ((long)(now - _ackAt[_ackHead]) >= 0)) {
+    uint8_t ack[4] = {CMD_HEADER_HIGH, CMD_HEADER_LOW, 0x01, _ackCmd[_ackHead]};
+    pBuf[got++] = ack[_ackOffset++];
+    if (_ackOffset == sizeof(ack)) {
+      _ackOffset = 0;
+      _ackHead = (_ackHead + 1) % LCD_EMU_ACK_QUEUE_LEN;
+      _ackCount--;
+    }
+  }
+  return got;
+}
+
+void DFRobot_LcdEmulator::discard()
+{
+  unsigned long now = micros();
+  while (_ackCount && ((long)(now - _ackAt[_ackHead]) >= 0)) {
+    _ackOffset = 0;
+    _ackHead = (_ackHead + 1) % LCD_EMU_ACK_QUEUE_LEN;
+    _ackCount--;
+  }
+}
+
+uint8_t DFRobot_LcdEmulator::minLength(uint8_t cmd, bool* fixed)
+{
+  *fixed = true;
+  switch (cmd) {
+    case CMD_OF_DRAW_PIXEL:             return CMD_DRAW_PIXEL_LEN;
+    case CMD_OF_DRAW_LINE:              return CMD_DRAW_LINE_LEN;
+    case CMD_OF_DRAW_RECT:              return CMD_OF_DRAW_RECT_LEN;
+    case CMD_OF_DRAW_CIRCLE:            return CMD_OF_DRAW_CIRCLE_LEN;
+    case CMD_OF_DRAW_TRIANGLE:          return CMD_OF_DRAW_TRIANGLE_LEN;
+    case CMD_OF_DRAW_ICON_INTERNAL:     return CMD_OF_DRAW_ICON_INTERNAL_LEN;
+    case CMD_OF_DRAW_GIF_INTERNAL:      return CMD_OF_DRAW_GIF_INTERNAL_LEN;
+    case CMD_OF_DRAW_BAR:               return CMD_OF_DRAW_BAR_LEN;
+    case CMD_OF_DRAW_SLIDER:            return CMD_OF_DRAW_SLIDER_LEN;
+    case CMD_OF_DRAW_COMPASS:           return CMD_DRAW_COMPASS_LEN;
+    case CMD_OF_DRAW_GAUGE:             return CMD_OF_DRAW_GAUGE_LEN;
+    case CMD_OF_DRAW_LINE_METER:        return CMD_OF_DRAW_LINE_METER_LEN;
+    case CMD_OF_DRAW_LINE_CHART:        return CMD_DRAW_CHART_LEN;
+    case CMD_OF_DRAW_SERIE:             return CMD_DRAW_SERIE_LEN;
+    case CMD_OF_DRAW_BAR_VALUE:         return CMD_SET_BAR_VALUE_LEN;
+    case CMD_OF_DRAW_SLIDER_VALUE:      return CMD_SET_SLIDER_VALUE_LEN;
+    case CMD_OF_DRAW_COMPASS_VALUE:     return CMD_SET_COMPASS_VALUE_LEN;
+    case CMD_OF_DRAW_GAUGE_VALUE:       return CMD_SET_GAUGE_VALUE_LEN;
+    case CMD_OF_DRAW_LINE_METER_VALUE:  return CMD_SET_LINE_METER_VALUE_LEN;
+    case CMD_SET_BACKGROUND_COLOR:      return CMD_SET_LEN;
+    case CMD_DELETE_OBJ:                return CMD_DELETE_OBJ_LEN;
+    case CMD_SET_TOP_OBJ:               return CMD_SET_TOP_OBJ_LEN;
+    case CMD_SET_ANGLE_OBJ:             return CMD_SET_ANGLE_OBJ_LEN;
+    case 0x1D:                          return 0x04;
+    default:
+      break;
+  }
+  *fixed = false;
+  switch (cmd) {
+    case CMD_OF_DRAW_ICON_EXTERNAL:     return 11;    // followed by the path
+    case CMD_OF_DRAW_GIF_EXTERNAL:      return 11;
+    case CMD_OF_DRAW_TEXT:              return 13;    // followed by the text
+    case CMD_SET_BACKGROUND_IMG:        return 5;
+    case CMD_OF_DRAW_LINE_CHART_TEXT:   return 6;
+    case CMD_OF_DRAW_SERIE_DATA:        return 8;     // followed by 16-bit points
+    default:                            return 0;
+  }
+}
+
+int8_t DFRobot_LcdEmulator::typeIndex(uint8_t type)
+{
+  switch (type) {
+    case CMD_OF_DRAW_LINE:          return 0;
+    case CMD_OF_DRAW_RECT:          return 1;
+    case CMD_OF_DRAW_CIRCLE:        return 2;
+    case CMD_OF_DRAW_TRIANGLE:      return 3;
+    case CMD_OF_DRAW_ICON_INTERNAL:
+    case CMD_OF_DRAW_ICON_EXTERNAL: return 4;
+    case CMD_OF_DRAW_GIF_INTERNAL:
+    case CMD_OF_DRAW_GIF_EXTERNAL:  return 5;
+    case CMD_OF_DRAW_SLIDER:        return 6;
+    case CMD_OF_DRAW_BAR:           return 7;
+    case CMD_OF_DRAW_GAUGE:         return 8;
+    case CMD_OF_DRAW_COMPASS:       return 9;
+    case CMD_OF_DRAW_TEXT:          return 10;
+    case CMD_OF_DRAW_LINE_METER:    return 11;
+    case CMD_OF_DRAW_LINE_CHART:    return 12;
+    case CMD_OF_DRAW_SERIE:         return 13;
+    default:                        return -1;
+  }
+}
+
+bool DFRobot_LcdEmulator::validID(uint8_t id)
+{
+  return (id != 0) && ((id - 1) / 8 < LCD_ID_MAP_LEN);
+}
+
+bool DFRobot_LcdEmulator::alive(int8_t row, uint8_t id)
+{
+  if ((row < 0) || !validID(id)) {
+    return false;
+  }
+  return _objects[row][(id - 1) / 8] & (1 << ((id - 1) % 8));
+}
+
+void DFRobot_LcdEmulator::setAlive(int8_t row, uint8_t id, bool alive)
+{
+  if (alive) {
+    _objects[row][(id - 1) / 8] |= (1 << ((id - 1) % 8));
+  } else {
+    _objects[row][(id - 1) / 8] &= ~(1 << ((id - 1) % 8));
+  }
+}
+
+bool DFRobot_LcdEmulator::isAlive(uint8_t type, uint8_t id)
+{
+  return alive(typeIndex(type), id);
+}
+
+uint16_t DFRobot_LcdEmulator::getObjectCount()
+{
+  uint16_t count = 0;
+  for (uint8_t row = 0; row < LCD_EMU_OBJECT_TYPE_NUM; row++) {
+    for (uint8_t i = 0; i < LCD_ID_MAP_LEN; i++) {
+      count += __builtin_popcount(_objects[row][i]);
+    }
+  }
+  return count;
+}
+
+DFRobot_LcdEmulator::sLcdEmuError_t DFRobot_LcdEmulator::check()
+{
+  uint8_t cmd = _frame[3];
+  uint16_t len = _frame[2] + CMDLEN_OF_HEAD_LEN;
+  bool fixed;
+  uint8_t minLen = minLength(cmd, &fixed);
+  if (minLen == 0) {
+    return eEmuBadCommand;
+  }
+  if ((len < minLen) || (fixed && (len != minLen))) {
+    return eEmuBadLength;
+  }
+
+  uint8_t id = _frame[4];
+  switch (cmd) {
+    case 0x1D:
+      memset(_objects, 0, sizeof(_objects));
+      return eEmuOK;
+
+    case CMD_OF_DRAW_PIXEL: {
+      uint16_t x = (_frame[7] << 8) | _frame[8];
+      uint16_t y = (_frame[9] << 8) | _frame[10];
+      return ((x < LCD_EMU_SCREEN_WIDTH) && (y < LCD_EMU_SCREEN_HEIGHT)) ? eEmuOK : eEmuOutOfRange;
+    }
+
+    case CMD_SET_BACKGROUND_COLOR:
+    case CMD_SET_BACKGROUND_IMG:
+      return eEmuOK;
+
+    case CMD_OF_DRAW_BAR_VALUE:
+      return alive(typeIndex(CMD_OF_DRAW_BAR), id) ? eEmuOK : eEmuNoObject;
+    case CMD_OF_DRAW_SLIDER_VALUE:
+      return alive(typeIndex(CMD_OF_DRAW_SLIDER), id) ? eEmuOK : eEmuNoObject;
+    case CMD_OF_DRAW_COMPASS_VALUE:
+      return alive(typeIndex(CMD_OF_DRAW_COMPASS), id) ? eEmuOK : eEmuNoObject;
+    case CMD_OF_DRAW_GAUGE_VALUE:
+      return alive(typeIndex(CMD_OF_DRAW_GAUGE), id) ? eEmuOK : eEmuNoObject;
+    case CMD_OF_DRAW_LINE_METER_VALUE:
+      return alive(typeIndex(CMD_OF_DRAW_LINE_METER), id) ? eEmuOK : eEmuNoObject;
+
+    case CMD_DELETE_OBJ:
+    case CMD_SET_TOP_OBJ:
+    case CMD_SET_ANGLE_OBJ: {
+      int8_t row = typeIndex(_frame[4]);
+      id = _frame[5];
+      if ((row < 0) || !validID(id)) {
+        return eEmuOutOfRange;
+      }
+      if (!alive(row, id)) {
+        return eEmuNoObject;
+      }
+      if (cmd == CMD_DELETE_OBJ) {
+        setAlive(row, id, false);
+      }
+      return eEmuOK;
+    }
+
+    case CMD_OF_DRAW_LINE_CHART_TEXT:
+      return alive(typeIndex(CMD_OF_DRAW_LINE_CHART), id) ? eEmuOK : eEmuNoObject;
+
+    case CMD_OF_DRAW_SERIE_DATA:
+      if ((len - minLen) % 2) {
+        return eEmuBadLength;
+      }
+      if (!alive(typeIndex(CMD_OF_DRAW_LINE_CHART), id) || !alive(typeIndex(CMD_OF_DRAW_SERIE), _frame[5])) {
+        return eEmuNoObject;
+      }
+      return eEmuOK;
+
+    case CMD_OF_DRAW_SERIE:
+      if (!alive(typeIndex(CMD_OF_DRAW_LINE_CHART), _frame[5])) {
+        return eEmuNoObject;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  // Draw commands create the object, or change it if the ID already exists
+  if (!validID(id)) {
+    return eEmuOutOfRange;
+  }
+  setAlive(typeIndex(cmd), id, true);
+  return eEmuOK;
+}
@@ -0,0 +1,231 @@
+/*!
+ * @file DFRobot_LcdEmulator.h
+ * @brief Software model of the DFR0997 module, used as a transport of DFRobot_LcdDisplayT
+ * @details Runs the library without hardware, e.g. on a Linux host or in CI: every frame is parsed and checked,
+ * @n the objects it creates and deletes are tracked, and the time the link and the module would need is modelled,
+ * @n so the effect of batching, queueing or flow control can be measured reproducibly.
+ * @n Example: DFRobot_LcdDisplayT<DFRobot_LcdEmulator> lcd(DFRobot_LcdEmulator(DFRobot_LcdEmulator::eEmuLinkI2C, 400000));
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @author [fengli](li.feng@dfrobot.com)
+ * @maintainer [qsjhyy](yihuan.huang@dfrobot.com)
+ * @maintainer [GDuang](yonglei.ren@dfrobot.com)
+ * @version  V2.0
+ * @date  2024-03-20
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#ifndef DFROBOT_LCDEMULATOR_H_
+#define DFROBOT_LCDEMULATOR_H_
+#include "DFRobot_LcdDisplay.h"
+
+#define LCD_EMU_CMD_NUM         0x21    //!< Command codes the emulator knows, 0 to CMD_OF_DRAW_GIF_EXTERNAL
+#define LCD_EMU_OBJECT_TYPE_NUM 14      //!< Object types the module keeps, whatever widget families the library was built with
+#define LCD_EMU_ACK_QUEUE_LEN   8       //!< Acknowledgements the emulator can hold before the library reads them
+#define LCD_EMU_SCREEN_WIDTH    320
+#define LCD_EMU_SCREEN_HEIGHT   240
+
+class DFRobot_LcdEmulator
+{
+public:
+  /**
+   * @enum sLcdEmuLink_t
+   * @brief Interface whose wire time is modelled
+   */
+  typedef enum {
+    eEmuLinkI2C,    /**<9 bits per byte plus the address byte and start/stop of every write */
+    eEmuLinkUART,   /**<10 bits per byte (8N1) */
+  }sLcdEmuLink_t;
+
+  /**
+   * @enum sLcdEmuError_t
+   * @brief What was wrong with a frame
+   */
+  typedef enum {
+    eEmuOK,
+    eEmuBadLength,    /**<Length field does not match the command */
+    eEmuBadCommand,   /**<Unknown command code */
+    eEmuOutOfRange,   /**<Object ID, object type or coordinate outside what the module accepts */
+    eEmuNoObject,     /**<Changes, raises or deletes an object that does not exist */
+    eEmuOverrun,      /**<Arrived while the module was still processing the previous frame */
+  }sLcdEmuError_t;
+
+  /**
+   * @fn DFRobot_LcdEmulator
+   * @brief constructor
+   * @param link Interface to model
+   * @param bitRate I2C clock or UART baud rate in bit/s
+   */
+  DFRobot_LcdEmulator(sLcdEmuLink_t link = eEmuLinkI2C, uint32_t bitRate = LCD_I2C_CLOCK_DEFAULT);
+
+  /**
+   * @fn begin
+   * @brief Power on the model: forget all objects, errors and statistics
+   * @return true
+   */
+  bool begin();
+
+  /**
+   * @fn write
+   * @brief Take bytes from the library, returning once the modelled wire time has passed
+   * @param pBuf Data
+   * @param len Length of the data
+   * @return len
+   */
+  uint16_t write(const uint8_t* pBuf, uint16_t len);
+
+  /**
+   * @fn read
+   * @brief Return the acknowledgements (0x55 0xAA 0x01 cmd) of frames whose processing has finished
+   * @n Only produced after setAck(true).
+   * @param pBuf Receives the data
+   * @param len Most bytes wanted
+   * @return Number of bytes read
+   */
+  uint16_t read(uint8_t* pBuf, uint16_t len);
+
+  /**
+   * @fn discard
+   * @brief Drop acknowledgements that are ready but were not read
+   */
+  void discard();
+
+  /**
+   * @fn setAck
+   * @brief Answer every frame with an acknowledgement once it is processed, for DFRobot_LcdDisplay::setFlowControl()
+   * @param enable true to acknowledge
+   */
+  void setAck(bool enable);
+
+  /**
+   * @fn setProcessTime
+   * @brief Set how long the module is busy after a frame of this command
+   * @n The defaults follow the settle times the library uses where it has one (cleanScreen() 1.5 s,
+   * @n setBackgroundColor() 300 ms, creatChart() 100 ms) and are estimates otherwise; calibrate them
+   * @n against a real module for absolute numbers.
+   * @param cmd Command code
+   * @param us Processing time in microseconds
+   */
+  void setProcessTime(uint8_t cmd, uint32_t us);
+
+  /**
+   * @fn isAlive
+   * @brief Whether an object exists on the modelled screen
+   * @param type Draw command of the object type, e.g. CMD_OF_DRAW_BAR
+   * @param id Object ID
+   * @return true if it was created and not deleted or cleared since
+   */
+  bool isAlive(uint8_t type, uint8_t id);
+
+  /**
+   * @fn getObjectCount
+   * @brief Get the number of objects on the modelled screen
+   * @return Number of objects of all types
+   */
+  uint16_t getObjectCount();
+
+  /**
+   * @fn getFrameCount
+   * @brief Get the number of complete frames received
+   * @return Number of frames
+   */
+  uint32_t getFrameCount() { return _frames; }
+
+  /**
+   * @fn getByteCount
+   * @brief Get the number of bytes received
+   * @return Number of bytes
+   */
+  uint32_t getByteCount() { return _bytes; }
+
+  /**
+   * @fn getErrorCount
+   * @brief Get the number of frames that were malformed, out of range, about missing objects or overran the module
+   * @return Number of bad frames
+   */
+  uint32_t getErrorCount() { return _errors; }
+
+  /**
+   * @fn getLastError
+   * @brief Get what was wrong with the last bad frame
+   * @return sLcdEmuError_t, eEmuOK if there was none
+   */
+  sLcdEmuError_t getLastError() { return _lastError; }
+
+  /**
+   * @fn getWireTime
+   * @brief Get the total modelled time the link spent transferring bytes
+   * @return Time in microseconds
+   */
+  uint32_t getWireTime() { return _wireTime; }
+
+  /**
+   * @fn getBusyTime
+   * @brief Get the total modelled time the module spent processing frames
+   * @return Time in microseconds
+   */
+  uint32_t getBusyTime() { return _busyTime; }
+
+private:
+  sLcdEmuLink_t _link;
+  uint32_t _bitRate;
+  bool _ack = false;
+  uint32_t _processTime[LCD_EMU_CMD_NUM];
+  uint8_t _objects[LCD_EMU_OBJECT_TYPE_NUM][LCD_ID_MAP_LEN];   // bit n set: ID n + 1 exists
+  uint8_t _frame[LCD_FRAME_MAX_LEN + CMDLEN_OF_HEAD_LEN];
+  uint16_t _frameLen = 0;
+  unsigned long _linkFreeAt = 0;
+  unsigned long _busyUntil = 0;
+  uint8_t _ackCmd[LCD_EMU_ACK_QUEUE_LEN];
+  unsigned long _ackAt[LCD_EMU_ACK_QUEUE_LEN];
+  uint8_t _ackHead = 0;
+  uint8_t _ackCount = 0;
+  uint8_t _ackOffset = 0;     // bytes of the acknowledgement at _ackHead already read
+  uint32_t _frames = 0;
+  uint32_t _bytes = 0;
+  uint32_t _errors = 0;
+  sLcdEmuError_t _lastError = eEmuOK;
+  uint32_t _wireTime = 0;
+  uint32_t _busyTime = 0;
+
+  /**
+   * @fn wireTime
+   * @brief Modelled time to transfer one write of len bytes
+   */
+  uint32_t wireTime(uint16_t len);
+
+  /**
+   * @fn execute
+   * @brief Check and apply the complete frame in _frame, which finished arriving at time done
+   */
+  void execute(unsigned long done);
+
+  /**
+   * @fn check
+   * @brief Check a complete frame against the protocol and the object table, and apply it
+   * @return eEmuOK or what was wrong
+   */
+  sLcdEmuError_t check();
+
+  /**
+   * @fn minLength
+   * @brief Shortest valid total frame length of a command
+   * @param cmd Command code
+   * @param fixed Set to true if frames of this command always have exactly this length
+   * @return Length, 0 for unknown commands
+   */
+  static uint8_t minLength(uint8_t cmd, bool* fixed);
+
+  /**
+   * @fn typeIndex
+   * @brief Row of _objects for the object a draw or delete command is about
+   * @param type Draw command (external icons and GIFs share the rows of the internal ones)
+   * @return Row index, -1 if the command does not create objects
+   */
+  static int8_t typeIndex(uint8_t type);
+
+  static bool validID(uint8_t id);
+  bool alive(int8_t row, uint8_t id);
+  void setAlive(int8_t row, uint8_t id, bool alive);
+};
+
+#endif
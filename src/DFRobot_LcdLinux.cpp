@@ -0,0 +1,214 @@
+/*!
+ * @file DFRobot_LcdLinux.cpp
+ * @brief Linux transports for DFRobot_LcdDisplayT
+ * @details i2c-dev and termios implementations of the transport interface used by DFRobot_LcdDisplayT
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @author [fengli](li.feng@dfrobot.com)
+ * @maintainer [qsjhyy](yihuan.huang@dfrobot.com)
+ * @maintainer [GDuang](yonglei.ren@dfrobot.com)
+ * @version  V2.0
+ * @date  2024-03-20
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "DFRobot_LcdLinux.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+DFRobot_LcdI2cDevTransport::DFRobot_LcdI2cDevTransport(const char* device, uint8_t addr)
+{
+  _device = device;
+  _deviceAddr = addr;
+  _fd = -1;
+  _noStart = false;
+}
+
+bool DFRobot_LcdI2cDevTransport::begin()
+{
+  end();
+  _fd = open(_device, O_RDWR);
+  if (_fd < 0) {
+    return false;
+  }
+  // A zero-length write is the i2c-dev equivalent of an address-only ping
+  struct i2c_msg msg = {_deviceAddr, 0, 0, NULL};
+  struct i2c_rdwr_ioctl_data data = {&msg, 1};
+  if (ioctl(_fd, I2C_RDWR, &data) < 0) {
+    end();
+    return false;
+  }
+  unsigned long funcs = 0;
+  _noStart = (ioctl(_fd, I2C_FUNCS, &funcs) == 0) && (funcs & I2C_FUNC_NOSTART);
+  return true;
+}
+
+void DFRobot_LcdI2cDevTransport::end()
+{
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+}
+
+uint16_t DFRobot_LcdI2cDevTransport::write(const uint8_t* pBuf, uint16_t len)
+{
+  return write(pBuf, len, NULL, 0);
+}
+
+uint16_t DFRobot_LcdI2cDevTransport::write(const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen)
+{
+  if (len > LCD_LINUX_I2C_MAX_LEN) {
+    len = LCD_LINUX_I2C_MAX_LEN;
+  }
+  if (moreLen > LCD_LINUX_I2C_MAX_LEN - len) {
+    moreLen = LCD_LINUX_I2C_MAX_LEN - len;
+  }
+  uint8_t joined[LCD_LINUX_JOIN_LEN];
+  struct i2c_msg msg[2] = {{_deviceAddr, 0, len, (uint8_t*)pBuf}, {_deviceAddr, I2C_M_NOSTART, moreLen, (uint8_t*)more}};
+  struct i2c_rdwr_ioctl_data data = {msg, (uint32_t)(moreLen ? 2 : 1)};
+  if (moreLen && !_noStart) {
+    // A second message would start a new transfer, join what fits into one instead
+    if (len >= sizeof(joined)) {
+      data.nmsgs = 1;
+      moreLen = 0;
+    } else {
+      if (moreLen > sizeof(joined) - len) {
+        moreLen = sizeof(joined) - len;
+      }
+      memcpy(joined, pBuf, len);
+      memcpy(joined + len, more, moreLen);
+      msg[0].buf = joined;
+      msg[0].len = len + moreLen;
+      data.nmsgs = 1;
+    }
+  }
+  if (ioctl(_fd, I2C_RDWR, &data) < 0) {
+    return 0;
+  }
+  return len + moreLen;
+}
+
+uint16_t DFRobot_LcdI2cDevTransport::read(uint8_t* pBuf, uint16_t len)
+{
+  if (len > LCD_LINUX_I2C_MAX_LEN) {
+    len = LCD_LINUX_I2C_MAX_LEN;
+  }
+  struct i2c_msg msg = {_deviceAddr, I2C_M_RD, len, pBuf};
+  struct i2c_rdwr_ioctl_data data = {&msg, 1};
+  if (ioctl(_fd, I2C_RDWR, &data) < 0) {
+    return 0;
+  }
+  return len;
+}
+
+DFRobot_LcdTermiosTransport::DFRobot_LcdTermiosTransport(const char* device, uint32_t baud)
+{
+  _device = device;
+  _baud = baud;
+  _fd = -1;
+}
+
+bool DFRobot_LcdTermiosTransport::begin()
+{
+  speed_t speed;
+  switch (_baud) {
+    case 9600:   speed = B9600;   break;
+    case 19200:  speed = B19200;  break;
+    case 38400:  speed = B38400;  break;
+    case 57600:  speed = B57600;  break;
+    case 115200: speed = B115200; break;
+    case 230400: speed = B230400; break;
+    case 460800: speed = B460800; break;
+    case 921600: speed = B921600; break;
+    default:
+      return false;
+  }
+
+  end();
+  _fd = open(_device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (_fd < 0) {
+    return false;
+  }
+  struct termios tio;
+  if (tcgetattr(_fd, &tio) < 0) {
+    end();
+    return false;
+  }
+  cfmakeraw(&tio);
+  tio.c_cflag |= CLOCAL | CREAD;
+  tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+  cfsetispeed(&tio, speed);
+  cfsetospeed(&tio, speed);
+  if (tcsetattr(_fd, TCSANOW, &tio) < 0) {
+    end();
+    return false;
+  }
+  tcflush(_fd, TCIOFLUSH);
+  return true;
+}
+
+void DFRobot_LcdTermiosTransport::end()
+{
+  if (_fd >= 0) {
+    close(_fd);
+    _fd = -1;
+  }
+}
+
+uint16_t DFRobot_LcdTermiosTransport::write(const uint8_t* pBuf, uint16_t len)
+{
+  return write(pBuf, len, NULL, 0);
+}
+
+uint16_t DFRobot_LcdTermiosTransport::write(const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen)
+{
+  struct iovec iov[2] = {{(void*)pBuf, len}, {(void*)more, moreLen}};
+  uint16_t total = len + moreLen;
+  uint16_t sent = 0;
+  while (sent < total) {
+    ssize_t n = ::writev(_fd, iov, 2);
+    if (n > 0) {
+      sent += n;
+      // Step past what the port took, which may end inside either piece
+      for (uint8_t i = 0; i < 2; i++) {
+        size_t step = ((size_t)n < iov[i].iov_len) ? (size_t)n : iov[i].iov_len;
+        iov[i].iov_base = (uint8_t*)iov[i].iov_base + step;
+        iov[i].iov_len -= step;
+        n -= step;
+      }
+      continue;
+    }
+    if ((n < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+      break;
+    }
+    // Output queue full, wait until the port drains a little
+    struct pollfd pfd = {_fd, POLLOUT, 0};
+    if (poll(&pfd, 1, LCD_LINUX_WRITE_TIMEOUT) <= 0) {
+      break;
+    }
+  }
+  return sent;
+}
+
+uint16_t DFRobot_LcdTermiosTransport::read(uint8_t* pBuf, uint16_t len)
+{
+  ssize_t n = ::read(_fd, pBuf, len);
+  return (n > 0) ? n : 0;
+}
+
+void DFRobot_LcdTermiosTransport::discard()
+{
+  tcflush(_fd, TCIFLUSH);
+}
+
+#endif
@@ -0,0 +1,172 @@
+/*!
+ * @file DFRobot_LcdLinux.h
+ * @brief Linux transports for DFRobot_LcdDisplayT
+ * @details Drive the DFR0997 from a Linux board (e.g. a Raspberry Pi) without an Arduino TwoWire or Stream:
+ * @n DFRobot_LcdI2cDevTransport talks to /dev/i2c-N, DFRobot_LcdTermiosTransport to a serial port such as /dev/ttyS0.
+ * @n Only compiled on Linux outside the Arduino build.
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @author [fengli](li.feng@dfrobot.com)
+ * @maintainer [qsjhyy](yihuan.huang@dfrobot.com)
+ * @maintainer [GDuang](yonglei.ren@dfrobot.com)
+ * @version  V2.0
+ * @date  2024-03-20
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#ifndef DFROBOT_LCDLINUX_H_
+#define DFROBOT_LCDLINUX_H_
+
+#if defined(__linux__) && !defined(ARDUINO)
+#include <stdint.h>
+
+#define LCD_LINUX_I2C_MAX_LEN   8192    //!< Longest single I2C_RDWR message the kernel accepts
+#define LCD_LINUX_WRITE_TIMEOUT 100     //!< Longest wait in ms for the serial port to accept more output
+#define LCD_LINUX_JOIN_LEN      256     //!< Bytes an I2C bus without I2C_M_NOSTART support can take from two pieces at once
+
+/**
+ * @brief I2C transport through the Linux i2c-dev interface
+ * @n Every write() is one I2C_RDWR ioctl, so a flushed batch of several frames goes out as a single transfer.
+ * @n Example: DFRobot_LcdDisplayT<DFRobot_LcdI2cDevTransport> lcd(DFRobot_LcdI2cDevTransport("/dev/i2c-1", 0x2c));
+ */
+class DFRobot_LcdI2cDevTransport
+{
+public:
+  /**
+   * @fn DFRobot_LcdI2cDevTransport
+   * @brief constructor
+   * @param device Path of the I2C bus device, e.g. "/dev/i2c-1"; the string must stay valid
+   * @param addr I2C address. The default value is 0x2c
+   */
+  DFRobot_LcdI2cDevTransport(const char* device = "/dev/i2c-1", uint8_t addr = 0x2c);
+
+  /**
+   * @fn begin
+   * @brief Open the bus device and check that the module answers
+   * @return true if the device could be opened and the module acknowledged its address
+   */
+  bool begin();
+
+  /**
+   * @fn end
+   * @brief Close the bus device
+   */
+  void end();
+
+  /**
+   * @fn write
+   * @brief Send pBuf in one I2C_RDWR transfer
+   * @param pBuf Data to send
+   * @param len Length of the data
+   * @return Number of bytes sent, at most LCD_LINUX_I2C_MAX_LEN; 0 on a bus error
+   */
+  uint16_t write(const uint8_t* pBuf, uint16_t len);
+
+  /**
+   * @fn write
+   * @brief Send pBuf and then more in one I2C_RDWR transfer
+   * @n The two pieces are two messages, the second one without a start condition (I2C_M_NOSTART), so the
+   * @n module sees a single write. If the bus driver lacks I2C_FUNC_NOSTART they are joined on the stack
+   * @n instead, up to LCD_LINUX_JOIN_LEN bytes.
+   * @param pBuf First piece
+   * @param len Length of the first piece
+   * @param more Second piece
+   * @param moreLen Length of the second piece
+   * @return Number of bytes sent; 0 on a bus error
+   */
+  uint16_t write(const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen);
+
+  /**
+   * @fn read
+   * @brief Read len bytes from the module in one I2C_RDWR transfer
+   * @param pBuf Receives the data
+   * @param len Number of bytes to read
+   * @return Number of bytes read, 0 on a bus error
+   */
+  uint16_t read(uint8_t* pBuf, uint16_t len);
+
+  /**
+   * @fn discard
+   * @brief Nothing to do, I2C has no input queue
+   */
+  void discard() {}
+
+private:
+  const char* _device;
+  uint8_t _deviceAddr;
+  int _fd;
+  bool _noStart;    // the bus driver supports I2C_M_NOSTART
+};
+
+/**
+ * @brief Serial transport through a non-blocking termios file descriptor
+ * @n Example: DFRobot_LcdDisplayT<DFRobot_LcdTermiosTransport> lcd(DFRobot_LcdTermiosTransport("/dev/ttyS0", 9600));
+ */
+class DFRobot_LcdTermiosTransport
+{
+public:
+  /**
+   * @fn DFRobot_LcdTermiosTransport
+   * @brief constructor
+   * @param device Path of the serial port, e.g. "/dev/ttyS0"; the string must stay valid
+   * @param baud Baud rate, one of the standard rates from 9600 to 921600
+   */
+  DFRobot_LcdTermiosTransport(const char* device = "/dev/ttyS0", uint32_t baud = 9600);
+
+  /**
+   * @fn begin
+   * @brief Open the port in raw, non-blocking mode with 8N1 framing
+   * @return true if the port could be opened and configured
+   */
+  bool begin();
+
+  /**
+   * @fn end
+   * @brief Close the port
+   */
+  void end();
+
+  /**
+   * @fn write
+   * @brief Write all of pBuf, using poll() to wait while the output queue of the port is full
+   * @param pBuf Data to send
+   * @param len Length of the data
+   * @return Number of bytes the port took, less than len if it stopped taking them for LCD_LINUX_WRITE_TIMEOUT ms
+   * @n or on an I/O error
+   */
+  uint16_t write(const uint8_t* pBuf, uint16_t len);
+
+  /**
+   * @fn write
+   * @brief Write all of pBuf and then of more with writev(), waiting like write(pBuf, len)
+   * @param pBuf First piece
+   * @param len Length of the first piece
+   * @param more Second piece
+   * @param moreLen Length of the second piece
+   * @return Number of bytes the port took from both pieces together
+   */
+  uint16_t write(const uint8_t* pBuf, uint16_t len, const uint8_t* more, uint16_t moreLen);
+
+  /**
+   * @fn read
+   * @brief Read what has arrived, without waiting for more
+   * @param pBuf Receives the data
+   * @param len Most bytes wanted
+   * @return Number of bytes read
+   */
+  uint16_t read(uint8_t* pBuf, uint16_t len);
+
+  /**
+   * @fn discard
+   * @brief Throw away input that has arrived but was not read yet
+   */
+  void discard();
+
+private:
+  const char* _device;
+  uint32_t _baud;
+  int _fd;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,41 @@
+/*!
+ * @file DFRobot_LcdPosix.cpp
+ * @brief The part of the Arduino core the library uses, for builds outside of it
+ * @details Time functions on CLOCK_MONOTONIC; see DFRobot_LcdPosix.h
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @author [fengli](li.feng@dfrobot.com)
+ * @maintainer [qsjhyy](yihuan.huang@dfrobot.com)
+ * @maintainer [GDuang](yonglei.ren@dfrobot.com)
+ * @version  V2.0
+ * @date  2024-03-20
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "DFRobot_LcdPosix.h"
+
+#if !defined(ARDUINO)
+#include <time.h>
+#include <errno.h>
+
+unsigned long micros()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (unsigned long)now.tv_sec * 1000000UL + now.tv_nsec / 1000;
+}
+
+unsigned long millis()
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (unsigned long)now.tv_sec * 1000UL + now.tv_nsec / 1000000;
+}
+
+void delay(unsigned long ms)
+{
+  struct timespec left = {(time_t)(ms / 1000), (long)(ms % 1000) * 1000000L};
+  while ((nanosleep(&left, &left) < 0) && (errno == EINTR)) {
+  }
+}
+
+#endif
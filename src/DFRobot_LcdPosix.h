@@ -0,0 +1,96 @@
+/*!
+ * @file DFRobot_LcdPosix.h
+ * @brief The part of the Arduino core the library uses, for builds outside of it
+ * @details Included by DFRobot_LcdDisplay.h instead of Arduino.h when ARDUINO is not defined, e.g. on a Linux board
+ * @n driving the module through DFRobot_LcdLinux.h: millis(), micros() and delay() on the monotonic clock,
+ * @n Print and Stream for DFRobot_Lcd_UART and the recorder, a String holding a copy of its text, and the
+ * @n program memory macros as no-ops. There is no Wire, so DFRobot_Lcd_IIC and DFRobot_LcdWireTransport are left out.
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @author [fengli](li.feng@dfrobot.com)
+ * @maintainer [qsjhyy](yihuan.huang@dfrobot.com)
+ * @maintainer [GDuang](yonglei.ren@dfrobot.com)
+ * @version  V2.0
+ * @date  2024-03-20
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#ifndef DFROBOT_LCDPOSIX_H_
+#define DFROBOT_LCDPOSIX_H_
+
+#if !defined(ARDUINO)
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <string>
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+inline void yield() {}
+
+#define PROGMEM
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper*)(s))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define vsnprintf_P vsnprintf
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t data) = 0;
+  virtual size_t write(const uint8_t* pBuf, size_t len)
+  {
+    size_t n = 0;
+    while (len--) {
+      n += write(*pBuf++);
+    }
+    return n;
+  }
+  size_t write(const char* str) { return write((const uint8_t*)str, strlen(str)); }
+  virtual void flush() {}
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  /**
+   * @fn readBytes
+   * @brief Read up to len bytes, stopping early when nothing more has arrived (there is no timeout)
+   * @return Number of bytes read
+   */
+  size_t readBytes(char* pBuf, size_t len)
+  {
+    size_t i = 0;
+    while (i < len) {
+      int c = read();
+      if (c < 0) {
+        break;
+      }
+      pBuf[i++] = c;
+    }
+    return i;
+  }
+};
+
+class String
+{
+public:
+  String() {}
+  String(const char* str) : _s(str ? str : "") {}
+  const char* c_str() const { return _s.c_str(); }
+  unsigned int length() const { return _s.size(); }
+
+private:
+  std::string _s;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,31 @@
+/*!
+ * @file check.h
+ * @brief CHECK(), CHECK_EQ() and TEST_DONE() of the host tests, with nothing from the Arduino core
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#ifndef LCD_TEST_CHECK_H_
+#define LCD_TEST_CHECK_H_
+#include <stdio.h>
+
+static int testFailures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+      printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      testFailures++; \
+    } \
+  } while (0)
+
+#define CHECK_EQ(a, b) do { \
+    long _a = (long)(a), _b = (long)(b); \
+    if (_a != _b) { \
+      printf("%s:%d: CHECK_EQ(%s, %s) failed: %ld != %ld\n", __FILE__, __LINE__, #a, #b, _a, _b); \
+      testFailures++; \
+    } \
+  } while (0)
+
+#define TEST_DONE() (printf("%s: %s\n", __FILE__, testFailures ? "FAILED" : "ok"), testFailures ? 1 : 0)
+
+#endif
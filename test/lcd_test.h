@@ -0,0 +1,131 @@
+/*!
+ * @file lcd_test.h
+ * @brief Fake buses shared by the host tests, and the checks of check.h
+ * @n Everything here uses fixed buffers, so the fakes never touch the heap and the allocation
+ * @n counter only sees what the library itself allocates.
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#ifndef LCD_TEST_H_
+#define LCD_TEST_H_
+#include "DFRobot_LcdDisplay.h"
+#include "check.h"
+
+/**
+ * @brief UART side of the module: records what the library writes and, when asked to, acknowledges
+ * @n each complete frame the way the module does with flow control enabled (55 AA 01 cmd).
+ */
+class FakeStream : public Stream
+{
+public:
+  static const uint16_t MAX_BYTES = 8192;
+  static const uint16_t MAX_WRITES = 1024;
+
+  uint8_t bytes[MAX_BYTES];
+  uint16_t len = 0;
+  uint16_t writeEnd[MAX_WRITES];   // offset in bytes[] where each write() call ended
+  uint16_t writes = 0;
+  bool ack = false;
+
+  size_t write(uint8_t data) { return write(&data, 1); }
+  size_t write(const uint8_t* pBuf, size_t n)
+  {
+    for (size_t i = 0; i < n; i++) {
+      put(pBuf[i]);
+    }
+    if (writes < MAX_WRITES) {
+      writeEnd[writes++] = len;
+    }
+    return n;
+  }
+  int available() { return _rxLen - _rxPos; }
+  int read() { return (_rxPos < _rxLen) ? _rx[_rxPos++] : -1; }
+  int peek() { return (_rxPos < _rxLen) ? _rx[_rxPos] : -1; }
+
+  void clear() { len = 0; writes = 0; _frameLen = 0; }
+
+  /**
+   * @brief Number of frames in what was written since clear()
+   */
+  uint16_t frames() const
+  {
+    uint16_t n = 0;
+    for (uint16_t i = 0; i + 3 < len; i += bytes[i + 2] + 3) {
+      n++;
+    }
+    return n;
+  }
+  /**
+   * @brief Command byte of frame `index`, 0 when there is no such frame
+   */
+  uint8_t cmd(uint16_t index) const
+  {
+    for (uint16_t i = 0; i + 3 < len; i += bytes[i + 2] + 3) {
+      if (index-- == 0) {
+        return bytes[i + 3];
+      }
+    }
+    return 0;
+  }
+  /**
+   * @brief Pointer to frame `index` (starting at 55 AA), NULL when there is no such frame
+   */
+  const uint8_t* frame(uint16_t index) const
+  {
+    for (uint16_t i = 0; i + 3 < len; i += bytes[i + 2] + 3) {
+      if (index-- == 0) {
+        return bytes + i;
+      }
+    }
+    return NULL;
+  }
+
+private:
+  void put(uint8_t data)
+  {
+    if (len < MAX_BYTES) {
+      bytes[len++] = data;
+    }
+    if (_frameLen < sizeof(_frame)) {
+      _frame[_frameLen] = data;
+    }
+    if (++_frameLen == 3) {
+      _frameNeed = data + 3;
+    }
+    if ((_frameLen > 3) && (_frameLen == _frameNeed)) {
+      if (ack && (_rxLen + 4u <= sizeof(_rx))) {
+        _rx[_rxLen++] = 0x55;
+        _rx[_rxLen++] = 0xAA;
+        _rx[_rxLen++] = 0x01;
+        _rx[_rxLen++] = _frame[3];
+      }
+      _frameLen = 0;
+    }
+    if (_rxPos == _rxLen) {
+      _rxPos = _rxLen = 0;
+    }
+  }
+
+  uint8_t _frame[4];
+  uint16_t _frameLen = 0;
+  uint16_t _frameNeed = 0;
+  uint8_t _rx[256];
+  uint16_t _rxLen = 0;
+  uint16_t _rxPos = 0;
+};
+
+/**
+ * @brief Send everything the async queues hold, advancing the clock 1 ms per poll()
+ */
+inline void pumpQueue(DFRobot_LcdDisplay& lcd)
+{
+#if !LCD_DISABLE_ASYNC
+  while (lcd.queueDepth()) {
+    lcd.poll();
+    hostMicros += 1000;
+  }
+#endif
+}
+
+#endif
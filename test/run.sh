@@ -0,0 +1,35 @@
+#!/bin/sh
+# Build and run the host tests: ./run.sh [test_name ...]
+# Each test_*.cpp is linked with the library sources and the small Arduino core in shim/.
+# Extra compiler flags can be passed in CXXFLAGS, e.g. CXXFLAGS=-DLCD_DISABLE_CHART=1 ./run.sh
+# A test that needs flags of its own names them in a "// build: <flags>" line.
+# A test with a "// core: posix" line is built like a Linux program instead: src/ alone, without ARDUINO
+# and without shim/, on the library's own POSIX layer (DFRobot_LcdPosix.h).
+set -e
+cd "$(dirname "$0")"
+CXX=${CXX:-g++}
+OUT=${OUT:-build}
+WARN="-Wall -Wextra -Wno-unused-parameter"
+mkdir -p "$OUT/posix"
+
+# The library must build from src/ alone on Linux
+for f in ../src/*.cpp; do
+  $CXX -std=gnu++11 -O1 $WARN $CXXFLAGS -D__linux__ -I ../src -c "$f" -o "$OUT/posix/$(basename "$f" .cpp).o"
+done
+
+if [ $# -eq 0 ]; then
+  set -- $(ls test_*.cpp | sed 's/\.cpp$//')
+fi
+fail=0
+for t in "$@"; do
+  flags=$(sed -n 's|^// build: ||p' "$t.cpp")
+  if grep -q '^// core: posix' "$t.cpp"; then
+    $CXX -std=gnu++11 -O1 -g $WARN $CXXFLAGS $flags -D__linux__ -I ../src \
+      "$t.cpp" ../src/*.cpp -o "$OUT/$t" -lpthread
+  else
+    $CXX -std=gnu++11 -O1 -g $WARN $CXXFLAGS $flags -DARDUINO -I shim -I ../src \
+      "$t.cpp" shim/shim.cpp ../src/*.cpp -o "$OUT/$t" -lpthread
+  fi
+  "./$OUT/$t" || fail=1
+done
+exit $fail
@@ -0,0 +1,123 @@
+/*!
+ * @file Arduino.h
+ * @brief Minimal Arduino core for the host tests: a simulated clock, Print/Stream and String
+ * @n Time only moves when the library looks at it or sleeps: every micros()/millis() call advances
+ * @n the clock by 1 us and delay() by the time asked for, so busy-waits end and sleeps can be summed.
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#ifndef LCD_TEST_ARDUINO_H_
+#define LCD_TEST_ARDUINO_H_
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string>
+
+extern unsigned long hostMicros;    //!< Simulated time in us
+extern unsigned long hostDelayMs;   //!< Total time spent in delay()
+extern unsigned long hostMallocs;   //!< Heap allocations of the whole process (malloc() and operator new)
+
+inline unsigned long micros() { return ++hostMicros; }
+inline unsigned long millis() { return ++hostMicros / 1000; }
+inline void delay(unsigned long ms) { hostMicros += ms * 1000; hostDelayMs += ms; }
+inline void delayMicroseconds(unsigned int us) { hostMicros += us; }
+inline void yield() {}
+
+#define PROGMEM
+#define PSTR(s) (s)
+class __FlashStringHelper;
+#define F(s) ((const __FlashStringHelper*)(s))
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define vsnprintf_P vsnprintf
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t data) = 0;
+  virtual size_t write(const uint8_t* pBuf, size_t len)
+  {
+    size_t n = 0;
+    while (len--) {
+      n += write(*pBuf++);
+    }
+    return n;
+  }
+  size_t write(const char* str) { return write((const uint8_t*)str, strlen(str)); }
+  size_t print(const char* str) { return write(str); }
+  size_t print(const __FlashStringHelper* str) { return write((const char*)str); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(long v, int base = 10) { char b[24]; snprintf(b, sizeof(b), (base == 16) ? "%lx" : "%ld", v); return write(b); }
+  size_t print(unsigned long v, int base = 10) { char b[24]; snprintf(b, sizeof(b), (base == 16) ? "%lx" : "%lu", v); return write(b); }
+  size_t print(int v, int base = 10) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = 10) { return print((unsigned long)v, base); }
+  size_t print(double v, int digits = 2) { char b[32]; snprintf(b, sizeof(b), "%.*f", digits, v); return write(b); }
+  size_t println() { return write("\r\n"); }
+  template <class T> size_t println(T v) { size_t n = print(v); return n + println(); }
+  template <class T> size_t println(T v, int x) { size_t n = print(v, x); return n + println(); }
+  virtual void flush() {}
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  size_t readBytes(char* pBuf, size_t len)
+  {
+    size_t i = 0;
+    while (i < len) {
+      int c = read();
+      if (c < 0) {
+        break;
+      }
+      pBuf[i++] = c;
+    }
+    return i;
+  }
+};
+
+class String
+{
+public:
+  String() {}
+  String(const char* str) : _s(str ? str : "") {}
+  String(const std::string& str) : _s(str) {}
+  String(int v) : _s(std::to_string(v)) {}
+  String(unsigned int v) : _s(std::to_string(v)) {}
+  String(long v) : _s(std::to_string(v)) {}
+  String(unsigned long v) : _s(std::to_string(v)) {}
+  String(unsigned char v) : _s(std::to_string(v)) {}
+  const char* c_str() const { return _s.c_str(); }
+  unsigned int length() const { return _s.size(); }
+  char operator[](unsigned int i) const { return _s[i]; }
+  String& operator+=(const char* str) { _s += str; return *this; }
+  String& operator+=(const String& str) { _s += str._s; return *this; }
+  friend String operator+(const String& a, const char* b) { return String(a._s + b); }
+
+private:
+  std::string _s;
+};
+
+/**
+ * @brief Serial: keeps what is printed so tests can check that the library stays quiet
+ */
+class HardwareSerial : public Stream
+{
+public:
+  std::string output;
+  void begin(unsigned long baud) { (void)baud; }
+  size_t write(uint8_t data) { output += (char)data; return 1; }
+  int available() { return 0; }
+  int read() { return -1; }
+  int peek() { return -1; }
+};
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,65 @@
+/*!
+ * @file Wire.h
+ * @brief TwoWire for the host tests: records every I2C transaction instead of driving a bus
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#ifndef LCD_TEST_WIRE_H_
+#define LCD_TEST_WIRE_H_
+#include "Arduino.h"
+
+#define BUFFER_LENGTH 32
+
+class TwoWire : public Stream
+{
+public:
+  static const uint16_t MAX_BYTES = 8192;
+  static const uint16_t MAX_TRANSACTIONS = 512;
+
+  uint32_t clock = 100000;
+  uint8_t addr[MAX_TRANSACTIONS];       // address of each transaction
+  uint16_t end[MAX_TRANSACTIONS];       // offset in bytes[] where each transaction ends
+  uint16_t transactions = 0;
+  uint8_t bytes[MAX_BYTES];             // everything written, all transactions back to back
+  uint16_t len = 0;
+  uint8_t nack = 0;                     // endTransmission() result to return, 0 = acknowledged
+
+  virtual void begin() {}
+  virtual void setClock(uint32_t c) { clock = c; }
+  virtual void beginTransmission(uint8_t a) { _addr = a; }
+  virtual uint8_t endTransmission(bool stop = true)
+  {
+    (void)stop;
+    if (transactions < MAX_TRANSACTIONS) {
+      addr[transactions] = _addr;
+      end[transactions++] = len;
+    }
+    return nack;
+  }
+  virtual uint8_t requestFrom(uint8_t a, uint8_t n) { (void)a; (void)n; return 0; }
+  size_t write(uint8_t data)
+  {
+    if (len < MAX_BYTES) {
+      bytes[len++] = data;
+    }
+    return 1;
+  }
+  size_t write(const uint8_t* pBuf, size_t n)
+  {
+    for (size_t i = 0; i < n; i++) {
+      write(pBuf[i]);
+    }
+    return n;
+  }
+  int available() { return 0; }
+  int read() { return -1; }
+  int peek() { return -1; }
+  void clear() { len = 0; transactions = 0; }
+
+private:
+  uint8_t _addr = 0;
+};
+extern TwoWire Wire;
+
+#endif
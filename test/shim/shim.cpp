@@ -0,0 +1,27 @@
+/*!
+ * @file shim.cpp
+ * @brief Globals of the host Arduino core and the heap allocation counter
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "Arduino.h"
+#include "Wire.h"
+
+unsigned long hostMicros = 0;
+unsigned long hostDelayMs = 0;
+unsigned long hostMallocs = 0;
+
+HardwareSerial Serial;
+TwoWire Wire;
+
+extern "C" void* __libc_malloc(size_t size);
+
+/**
+ * @brief Count every heap allocation; operator new ends up here too
+ */
+extern "C" void* malloc(size_t size)
+{
+  hostMallocs++;
+  return __libc_malloc(size);
+}
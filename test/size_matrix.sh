@@ -0,0 +1,36 @@
+#!/bin/sh
+# Flash and SRAM use of a sketch for each set of feature and mode switches: ./size_matrix.sh [sketch] [fqbn]
+# Builds the sketch once per line of $CONFIGS with arduino-cli; the display object is a global in the
+# examples, so its buffers show up under "Global variables". Defaults to examples/graphics on an Uno.
+# The mode switches default to 1 on AVR and to 0 elsewhere, so the =0 lines only differ on AVR and the =1 lines elsewhere.
+set -e
+cd "$(dirname "$0")"
+SKETCH=${1:-../examples/graphics}
+FQBN=${2:-arduino:avr:uno}
+CONFIGS=${CONFIGS:-"
+-DLCD_DISABLE_CHART=1
+-DLCD_DISABLE_METER=1
+-DLCD_DISABLE_GIF=1
+-DLCD_DISABLE_EXTERNAL_ICON=1
+-DLCD_DISABLE_TEXT=1
+-DLCD_DISABLE_BATCH=1
+-DLCD_DISABLE_ASYNC=1
+-DLCD_DISABLE_SHADOW=1
+-DLCD_DISABLE_BATCH=1 -DLCD_DISABLE_ASYNC=1 -DLCD_DISABLE_SHADOW=1
+-DLCD_DISABLE_BATCH=0
+-DLCD_DISABLE_ASYNC=0
+-DLCD_DISABLE_SHADOW=0
+-DLCD_DISABLE_BATCH=0 -DLCD_DISABLE_ASYNC=0 -DLCD_DISABLE_SHADOW=0
+-DLCD_DISABLE_CHART=1 -DLCD_DISABLE_METER=1 -DLCD_DISABLE_GIF=1 -DLCD_DISABLE_BATCH=1 -DLCD_DISABLE_ASYNC=1 -DLCD_DISABLE_SHADOW=1"}
+
+printf "%8s %8s  %s\n" flash sram flags
+# The empty first line of CONFIGS builds the defaults
+printf "%s\n" "$CONFIGS" | while IFS= read -r f; do
+  out=$(arduino-cli compile --clean --fqbn "$FQBN" --build-property "compiler.cpp.extra_flags=$f" "$SKETCH" 2>&1) || {
+    printf "%8s %8s  %s\n" - - "${f:-(defaults)}: build failed"
+    continue
+  }
+  flash=$(echo "$out" | sed -n 's/^Sketch uses \([0-9]*\) bytes.*/\1/p')
+  sram=$(echo "$out" | sed -n 's/^Global variables use \([0-9]*\) bytes.*/\1/p')
+  printf "%8s %8s  %s\n" "$flash" "$sram" "${f:-(defaults)}"
+done
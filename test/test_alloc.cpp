@@ -0,0 +1,185 @@
+/*!
+ * @file test_alloc.cpp
+ * @brief Every API call encodes its frame without touching the heap, on both transports; object IDs run out cleanly
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "lcd_test.h"
+
+#define NO_ALLOC(call) do { \
+    unsigned long _m = hostMallocs; \
+    call; \
+    if (hostMallocs != _m) { \
+      printf("%s:%d: %s allocated %lu times\n", __FILE__, __LINE__, #call, hostMallocs - _m); \
+      testFailures++; \
+    } \
+  } while (0)
+
+static void drawAll(DFRobot_LcdDisplay& lcd)
+{
+  uint16_t points[5] = {1, 300, 65535, 4, 5};
+  NO_ALLOC(lcd.setBackgroundColor(0x123456));
+  NO_ALLOC(lcd.cleanScreen());
+  NO_ALLOC(lcd.drawPixel(330, 250, 0xABCDEF));
+  uint8_t id = 0;
+  NO_ALLOC(id = lcd.drawLine(1, 2, 300, -4, 3, 0x102030));
+  NO_ALLOC(lcd.updateLine(id, 5, 6, 7, 8, 2, 0x405060));
+  NO_ALLOC(lcd.deleteLine(id));
+  NO_ALLOC(id = lcd.drawRect(10, 20, 30, 40, 2, 0x111111, 1, 0x222222, 1));
+  NO_ALLOC(lcd.updateRect(id, 11, 21, 31, 41, 3, 0x333333, 0, 0x444444, 0));
+  NO_ALLOC(lcd.deleteRect(id));
+  NO_ALLOC(id = lcd.drawCircle(100, 110, 50, 2, 0x555555, 1, 0x666666));
+  NO_ALLOC(lcd.updateCircle(id, 101, 111, 51, 3, 0x777777, 0, 0x888888));
+  NO_ALLOC(lcd.deleteCircle(id));
+  NO_ALLOC(id = lcd.drawTriangle(1, 2, 3, 4, 5, 6, 1, 0x999999, 1, 0xaaaaaa));
+  NO_ALLOC(lcd.updateTriangle(id, -1, -2, -3, -4, -5, -6, 2, 0xbbbbbb, 0, 0xcccccc));
+  NO_ALLOC(lcd.deleteTriangle(id));
+  NO_ALLOC(id = lcd.drawIcon(10, 20, lcd.eIconBee, 300));
+  NO_ALLOC(lcd.setAngleIcon(id, -90));
+  NO_ALLOC(lcd.updateIcon(id, 1, 2, 5, 128));
+  NO_ALLOC(lcd.deleteIcon(id));
+  NO_ALLOC(id = lcd.drawGif(3, 4, lcd.eGifSun, 200));
+  NO_ALLOC(lcd.deleteGif(id));
+  NO_ALLOC(id = lcd.creatSlider(1, 2, 300, 20, 0xF800));
+  NO_ALLOC(lcd.updateSlider(id, 2, 3, 301, 21, 0x07E0));
+  NO_ALLOC(lcd.setSliderValue(id, 513));
+  NO_ALLOC(lcd.deleteSlider(id));
+  NO_ALLOC(id = lcd.creatBar(1, 2, 300, 20, 0x123456));
+  NO_ALLOC(lcd.updateBar(id, 2, 3, 301, 21, 0x654321));
+  NO_ALLOC(lcd.setBarValue(id, 999));
+  NO_ALLOC(lcd.deleteBar(id));
+  uint8_t series = 0;
+  NO_ALLOC(id = lcd.creatChart("a b c", "1 2 3", 0x010203, 1));
+  NO_ALLOC(lcd.updateChart(id, 0x030201, 2));
+  NO_ALLOC(series = lcd.creatChartSeries(id, 0xff00ff));
+  NO_ALLOC(lcd.updateChartSeries(id, series, 0x00ff00));
+  NO_ALLOC(lcd.addChartSeriesData(id, series, points, 5));
+  NO_ALLOC(lcd.updateChartPoint(id, series, 3, 777));
+  NO_ALLOC(lcd.setTopChart(id));
+  NO_ALLOC(lcd.deleteChart(id));
+  NO_ALLOC(id = lcd.creatGauge(1, 2, 100, 0, 360, 0x111111, 0x222222));
+  NO_ALLOC(lcd.updateGauge(id, 2, 3, 101, 1, 361, 0x333333, 0x444444));
+  NO_ALLOC(lcd.setGaugeValue(id, 300));
+  NO_ALLOC(lcd.deleteGauge(id));
+  NO_ALLOC(id = lcd.creatCompass(1, 2, 100));
+  NO_ALLOC(lcd.updateCompass(id, 2, 3, 101));
+  NO_ALLOC(lcd.setCompassScale(id, 270));
+  NO_ALLOC(lcd.deleteCompass(id));
+  NO_ALLOC(id = lcd.creatLineMeter(1, 2, 100, 0, 100, 0x111111, 0x222222));
+  NO_ALLOC(lcd.updateLineMeter(id, 2, 3, 101, 1, 101, 0x333333, 0x444444));
+  NO_ALLOC(lcd.setMeterValue(id, 50));
+  NO_ALLOC(lcd.setTopLineMeter(id));
+  NO_ALLOC(lcd.deleteLineMeter(id));
+  NO_ALLOC(id = lcd.drawString(10, 20, "Hello", 0, 0xFFFFFF));
+  NO_ALLOC(lcd.updateString(id, 11, 21, "World!", 1, 0x000001));
+  NO_ALLOC(lcd.deleteString(id));
+  NO_ALLOC(id = lcd.drawLcdTime(10, 20, 9, 8, 7, 0, 0xFFFF));
+  NO_ALLOC(lcd.updateLcdTime(id, 10, 20, 19, 58, 57, 0, 0xFFFF));
+  NO_ALLOC(lcd.drawLcdDate(10, 20, 3, 29, 3, 0, 0xFFFF));
+}
+
+static FakeStream stream;
+
+/**
+ * @brief Run one call; with noAlloc set, fail if it allocates
+ */
+#define CAPTURE(call, noAlloc) do { \
+    unsigned long _m = hostMallocs; \
+    call; \
+    if (noAlloc && (hostMallocs != _m)) { \
+      printf("%s:%d: %s allocated %lu times\n", __FILE__, __LINE__, #call, hostMallocs - _m); \
+      testFailures++; \
+    } \
+  } while (0)
+
+/**
+ * @brief The String call and the three zero-copy calls must write the same bytes, and only the String one may allocate
+ */
+#define SAME_FRAMES(withString, a, b, c) do { \
+    uint16_t _start[5]; \
+    _start[0] = stream.len; CAPTURE(withString, false); \
+    _start[1] = stream.len; CAPTURE(a, true); \
+    _start[2] = stream.len; CAPTURE(b, true); \
+    _start[3] = stream.len; CAPTURE(c, true); \
+    _start[4] = stream.len; \
+    uint16_t _n = _start[1] - _start[0]; \
+    for (uint8_t _i = 1; _i < 4; _i++) { \
+      if ((_start[_i + 1] - _start[_i] != _n) || memcmp(stream.bytes + _start[0], stream.bytes + _start[_i], _n)) { \
+        printf("%s:%d: call %u differs from %s\n", __FILE__, __LINE__, _i, #withString); \
+        testFailures++; \
+      } \
+    } \
+    stream.clear(); \
+  } while (0)
+
+static void textAll(DFRobot_LcdDisplay& lcd)
+{
+  String str("U:/pictures/background.png");
+  char buf[] = "U:/pictures/background.png and more";
+  uint16_t len = strlen(str.c_str());
+  #define TEXT "U:/pictures/background.png"
+  SAME_FRAMES(lcd.setBackgroundImg(1, str), lcd.setBackgroundImg(1, TEXT),
+              lcd.setBackgroundImg(1, buf, len), lcd.setBackgroundImg(1, F(TEXT)));
+  SAME_FRAMES(lcd.updateString(1, 2, 3, str, 0, 5), lcd.updateString(1, 2, 3, TEXT, 0, 5),
+              lcd.updateString(1, 2, 3, buf, len, 0, 5), lcd.updateString(1, 2, 3, F(TEXT), 0, 5));
+  SAME_FRAMES(lcd.deleteString(lcd.drawString(1, 2, str, 0, 5)), lcd.deleteString(lcd.drawString(1, 2, TEXT, 0, 5)),
+              lcd.deleteString(lcd.drawString(1, 2, buf, len, 0, 5)), lcd.deleteString(lcd.drawString(1, 2, F(TEXT), 0, 5)));
+  SAME_FRAMES(lcd.updateIcon(1, 2, 3, str, 9), lcd.updateIcon(1, 2, 3, TEXT, 9),
+              lcd.updateIcon(1, 2, 3, buf, len, 9), lcd.updateIcon(1, 2, 3, F(TEXT), 9));
+  SAME_FRAMES(lcd.deleteIcon(lcd.drawIcon(2, 3, str, 9)), lcd.deleteIcon(lcd.drawIcon(2, 3, TEXT, 9)),
+              lcd.deleteIcon(lcd.drawIcon(2, 3, buf, len, 9)), lcd.deleteIcon(lcd.drawIcon(2, 3, F(TEXT), 9)));
+  SAME_FRAMES(lcd.deleteGif(lcd.drawGif(2, 3, str, 9)), lcd.deleteGif(lcd.drawGif(2, 3, TEXT, 9)),
+              lcd.deleteGif(lcd.drawGif(2, 3, buf, len, 9)), lcd.deleteGif(lcd.drawGif(2, 3, F(TEXT), 9)));
+  SAME_FRAMES(lcd.deleteChart(lcd.creatChart(str, str, 1, 1)), lcd.deleteChart(lcd.creatChart(TEXT, TEXT, 1, 1)),
+              lcd.deleteChart(lcd.creatChart(buf, len, buf, len, 1, 1)), lcd.deleteChart(lcd.creatChart(F(TEXT), F(TEXT), 1, 1)));
+  SAME_FRAMES(lcd.updateString(1, 2, 3, String(42) + " lux, a longer label", 0, 5),
+              lcd.updateStringf(1, 2, 3, 0, 5, "%d lux, a longer label", 42),
+              lcd.updateStringf(1, 2, 3, 0, 5, F("%d lux, a longer label"), 42),
+              lcd.updateString(1, 2, 3, "42 lux, a longer label", 0, 5));
+  #undef TEXT
+}
+
+/**
+ * @brief LCD_MAX_OBJECT_ID objects of one type, then 0 and eLcdNoFreeID without a word on Serial; freed IDs come back
+ */
+static void idsAll(DFRobot_LcdDisplay& lcd)
+{
+  Serial.output.clear();
+  CHECK_EQ(lcd.getLastError(), DFRobot_LcdDisplay::eLcdOK);
+  for (uint16_t i = 1; i <= LCD_MAX_OBJECT_ID; i++) {
+    CHECK_EQ(lcd.creatBar(1, 2, 300, 20, 0x123456), i);
+  }
+  CHECK_EQ(lcd.getLastError(), DFRobot_LcdDisplay::eLcdOK);
+  CHECK_EQ(lcd.creatBar(1, 2, 300, 20, 0x123456), 0);
+  CHECK_EQ(lcd.getLastError(), DFRobot_LcdDisplay::eLcdNoFreeID);
+  CHECK_EQ(lcd.getLastError(), DFRobot_LcdDisplay::eLcdOK);
+  CHECK(Serial.output.empty());
+
+  // Other types are not affected, and a deleted bar makes room for exactly one more
+  CHECK_EQ(lcd.drawLine(1, 2, 3, 4, 1, 0), 1);
+  lcd.deleteBar(17);
+  CHECK_EQ(lcd.creatBar(1, 2, 300, 20, 0x123456), 17);
+  CHECK_EQ(lcd.creatBar(1, 2, 300, 20, 0x123456), 0);
+}
+
+int main()
+{
+  DFRobot_Lcd_UART uart(stream);
+  uart.begin();
+  drawAll(uart);
+  CHECK(stream.frames() > 50);
+  stream.clear();
+  textAll(uart);
+
+  DFRobot_Lcd_IIC iic(&Wire, 0x2c);
+  iic.begin();
+  drawAll(iic);
+  CHECK(Wire.transactions > 50);
+
+  DFRobot_Lcd_UART ids(stream);
+  ids.begin();
+  idsAll(ids);
+
+  return TEST_DONE();
+}
@@ -0,0 +1,228 @@
+/*!
+ * @file test_async.cpp
+ * @brief Asynchronous queue: frames go out in a safe order, with bounded time per poll()
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "lcd_test.h"
+
+static FakeStream stream;
+
+/**
+ * @brief Index of the first frame with command cmd, -1 if none
+ */
+static int findCmd(uint8_t cmd)
+{
+  for (uint16_t i = 0; i < stream.frames(); i++) {
+    if (stream.cmd(i) == cmd) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Layout changes of a dashboard refresh, none of them a value setter
+ */
+static void layout(DFRobot_LcdDisplay& lcd)
+{
+  for (uint8_t id = 1; id <= 4; id++) {
+    lcd.updateBar(id, 10, 40 * id, 100, 20, 0x00FF00);
+    lcd.drawPixel(id, id, 0xFF0000);
+  }
+  lcd.updateString(1, 10, 200, "42 lux", 0, 0xFFFFFF);
+  lcd.updateString(2, 10, 220, "21.5 C", 0, 0xFFFFFF);
+}
+
+static void testRefreshDoesNotBlock()
+{
+  DFRobot_Lcd_UART lcd(stream);
+  lcd.begin();
+  stream.clear();
+  layout(lcd);
+  static uint8_t immediate[FakeStream::MAX_BYTES];
+  uint16_t immediateLen = stream.len;
+  memcpy(immediate, stream.bytes, immediateLen);
+
+  // API calls only queue; each poll() writes at most one chunk and never sleeps
+  lcd.setAsync(true);
+  stream.clear();
+  hostDelayMs = 0;
+  layout(lcd);
+  CHECK_EQ(stream.len, 0);
+  CHECK_EQ(lcd.queueDepth(), 10);
+  uint16_t polls = 0;
+  while (lcd.queueDepth() && (polls < 10000)) {
+    uint16_t writes = stream.writes;
+    uint16_t len = stream.len;
+    lcd.poll();
+    CHECK(stream.writes - writes <= 1);
+    CHECK(stream.len - len <= LCD_ASYNC_CHUNK_LEN);
+    hostMicros += 1000;
+    polls++;
+  }
+  CHECK_EQ(hostDelayMs, 0);
+  CHECK_EQ(lcd.queueDepth(), 0);
+  // Same frames in the same order as immediate mode
+  CHECK_EQ(stream.len, immediateLen);
+  CHECK(memcmp(stream.bytes, immediate, immediateLen) == 0);
+  // ...with the settle time between writes waited out by poll() returning, not by sleeping
+  CHECK(stream.writes > 1);
+  CHECK(polls >= (stream.writes - 1) * LCD_SETTLE_TIME_MS);
+  stream.clear();
+}
+
+static void testValuesOvertakeLayout()
+{
+  DFRobot_Lcd_UART lcd(stream);
+  lcd.begin();
+  lcd.setAsync(true);
+  stream.clear();
+  layout(lcd);
+  lcd.setGaugeValue(7, 50);
+  pumpQueue(lcd);
+  CHECK_EQ(stream.frames(), 11);
+  int value = findCmd(CMD_OF_DRAW_GAUGE_VALUE);
+  CHECK(value >= 0);
+  CHECK(value < 10);
+
+  // ...but not the frames of their own object
+  stream.clear();
+  uint8_t gauge = lcd.creatGauge(1, 2, 100, 0, 100, 0x111111, 0x222222);
+  lcd.setGaugeValue(gauge, 50);
+  lcd.deleteGauge(gauge);
+  lcd.setBarValue(1, 5);
+  lcd.cleanScreen();
+  lcd.setBarValue(1, 6);
+  pumpQueue(lcd);
+  CHECK_EQ(stream.frames(), 6);
+  CHECK(findCmd(CMD_OF_DRAW_GAUGE) < findCmd(CMD_OF_DRAW_GAUGE_VALUE));
+  CHECK(findCmd(CMD_OF_DRAW_GAUGE_VALUE) < findCmd(CMD_DELETE_OBJ));
+  CHECK(findCmd(0x1D) < 5);
+  CHECK_EQ(stream.cmd(5), CMD_OF_DRAW_BAR_VALUE);
+  CHECK_EQ(stream.frame(5)[6], 6);
+  stream.clear();
+}
+
+static void testPolicies()
+{
+  DFRobot_Lcd_UART lcd(stream);
+  lcd.begin();
+
+  // eQueueBlock: a full queue makes the call wait, nothing is lost or reordered
+  lcd.setAsync(true, DFRobot_LcdDisplay::eQueueBlock);
+  stream.clear();
+  for (uint8_t i = 0; i < 100; i++) {
+    lcd.drawPixel(0, 0, i);
+  }
+  pumpQueue(lcd);
+  CHECK_EQ(stream.frames(), 100);
+  CHECK_EQ(lcd.getDroppedCount(), 0);
+  for (uint8_t i = 0; i < 100; i++) {
+    CHECK_EQ(stream.frame(i)[6], i);
+  }
+
+  // eQueueDrop: frames that do not fit are counted and left out, the rest keep their order
+  lcd.setAsync(true, DFRobot_LcdDisplay::eQueueDrop);
+  stream.clear();
+  for (uint8_t i = 0; i < 100; i++) {
+    lcd.drawPixel(0, 0, i);
+  }
+  pumpQueue(lcd);
+  CHECK(lcd.getDroppedCount() > 0);
+  CHECK_EQ(stream.frames() + lcd.getDroppedCount(), 100);
+  for (uint8_t i = 1; i < stream.frames(); i++) {
+    CHECK(stream.frame(i)[6] > stream.frame(i - 1)[6]);
+  }
+
+  // eQueueCoalesce: a full queue takes the new frame in place of the queued one for the same object
+  lcd.setAsync(true, DFRobot_LcdDisplay::eQueueCoalesce);
+  stream.clear();
+  uint32_t dropped = lcd.getDroppedCount();
+  uint32_t coalesced = lcd.getCoalescedCount();
+  for (uint8_t round = 0; round < 20; round++) {
+    for (uint8_t id = 1; id <= 4; id++) {
+      lcd.updateBar(id, 0, 0, 100, 20, round);
+    }
+  }
+  pumpQueue(lcd);
+  CHECK_EQ(lcd.getDroppedCount(), dropped);
+  CHECK(lcd.getCoalescedCount() > coalesced);
+  CHECK_EQ(stream.frames() + lcd.getCoalescedCount() - coalesced, 80);
+  // The screen ends up with the last geometry of each bar
+  for (uint8_t id = 1; id <= 4; id++) {
+    const uint8_t* last = NULL;
+    for (uint16_t i = 0; i < stream.frames(); i++) {
+      if (stream.frame(i)[4] == id) {
+        last = stream.frame(i);
+      }
+    }
+    CHECK(last != NULL);
+    CHECK((last != NULL) && (last[7] == 19));
+  }
+
+  // Values always coalesce while queued, whatever the policy
+  lcd.setAsync(true, DFRobot_LcdDisplay::eQueueBlock);
+  stream.clear();
+  for (uint8_t v = 0; v < 50; v++) {
+    lcd.setBarValue(1, v);
+  }
+  pumpQueue(lcd);
+  CHECK_EQ(stream.frames(), 1);
+  CHECK_EQ(stream.frame(0)[6], 49);
+  stream.clear();
+}
+
+static void testDeadlineForgetsShadow()
+{
+  DFRobot_Lcd_UART lcd(stream);
+  lcd.begin();
+  lcd.setAsync(true);
+  lcd.setShadowCache(true);
+  uint8_t bar = lcd.creatBar(1, 2, 300, 20, 0x123456);
+
+  // Queued behind the settle time of creatBar and expired before poll() gets to it
+  lcd.setDeadline(5);
+  lcd.updateBar(bar, 2, 3, 301, 21, 0x654321);
+  lcd.setDeadline(0);
+  hostMicros += 100000;
+  pumpQueue(lcd);
+  CHECK_EQ(lcd.getDroppedCount(), 1);
+  CHECK_EQ(findCmd(CMD_OF_DRAW_BAR), 0);
+  CHECK_EQ(stream.frames(), 1);
+
+  // The module never saw it, so the same update again is not a shadow hit
+  stream.clear();
+  lcd.updateBar(bar, 2, 3, 301, 21, 0x654321);
+  pumpQueue(lcd);
+  CHECK_EQ(stream.frames(), 1);
+  CHECK_EQ(stream.cmd(0), CMD_OF_DRAW_BAR);
+  stream.clear();
+}
+
+static void testAngleWaitsForPathIcon()
+{
+  DFRobot_Lcd_UART lcd(stream);
+  lcd.begin();
+  lcd.setAsync(true);
+  lcd.creatBar(1, 2, 300, 20, 0x123456);
+
+  // The icon from a path is still queued when its angle is set; the angle must not overtake it
+  uint8_t icon = lcd.drawIcon(10, 20, "U:/a.png", 256);
+  lcd.setAngleIcon(icon, 90);
+  pumpQueue(lcd);
+  CHECK(findCmd(CMD_OF_DRAW_ICON_EXTERNAL) >= 0);
+  CHECK(findCmd(CMD_OF_DRAW_ICON_EXTERNAL) < findCmd(CMD_SET_ANGLE_OBJ));
+  stream.clear();
+}
+
+int main()
+{
+  testRefreshDoesNotBlock();
+  testValuesOvertakeLayout();
+  testPolicies();
+  testDeadlineForgetsShadow();
+  testAngleWaitsForPathIcon();
+  return TEST_DONE();
+}
@@ -0,0 +1,189 @@
+/*!
+ * @file test_batch.cpp
+ * @brief Batch mode: the same frames in the same order as immediate mode, in fewer writes and settle times
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "lcd_test.h"
+
+static FakeStream stream;
+static uint8_t immediate[FakeStream::MAX_BYTES];
+static uint16_t immediateLen;
+
+/**
+ * @brief Refresh a 12-widget dashboard; no frame needs a settle time of its own
+ */
+static void dashboard(DFRobot_LcdDisplay& lcd, uint8_t value)
+{
+  for (uint8_t id = 1; id <= 4; id++) {
+    lcd.setBarValue(id, value + id);
+    lcd.setGaugeValue(id, value * id);
+  }
+  lcd.updateString(1, 10, 200, "42 lux", 0, 0xFFFFFF);
+  lcd.updateString(2, 10, 220, "21.5 C", 0, 0xFFFFFF);
+  lcd.drawPixel(value, value, 0xFF0000);
+  lcd.updateBar(1, 10, 40, 100, 20, 0x00FF00);
+}
+
+static void recordImmediate(DFRobot_LcdDisplay& lcd)
+{
+  stream.clear();
+  dashboard(lcd, 7);
+  memcpy(immediate, stream.bytes, stream.len);
+  immediateLen = stream.len;
+}
+
+static bool sameAsImmediate()
+{
+  return (stream.len == immediateLen) && (memcmp(stream.bytes, immediate, immediateLen) == 0);
+}
+
+static void testUart()
+{
+  DFRobot_Lcd_UART lcd(stream);
+  lcd.begin();
+
+  hostDelayMs = 0;
+  recordImmediate(lcd);
+  CHECK_EQ(stream.frames(), 12);
+  CHECK_EQ(hostDelayMs, 12 * LCD_SETTLE_TIME_MS);
+
+  // One write and one settle time for the whole refresh, a few when the batch buffer is small
+  stream.clear();
+  hostDelayMs = 0;
+  lcd.beginBatch();
+  dashboard(lcd, 7);
+  lcd.endBatch();
+  CHECK(sameAsImmediate());
+  if (immediateLen <= LCD_BATCH_BUF_LEN) {
+    CHECK_EQ(stream.writes, 1);
+  }
+  CHECK(stream.writes < 12);
+  CHECK_EQ(hostDelayMs, stream.writes * LCD_SETTLE_TIME_MS);
+
+  // flush() sends what has been collected and stays in batch mode
+  stream.clear();
+  lcd.beginBatch();
+  lcd.setBarValue(1, 1);
+  lcd.flush();
+  CHECK_EQ(stream.writes, 1);
+  lcd.setBarValue(2, 2);
+  CHECK_EQ(stream.writes, 1);
+  lcd.endBatch();
+  CHECK_EQ(stream.writes, 2);
+  CHECK_EQ(stream.frames(), 2);
+}
+
+static void testOverflow()
+{
+  DFRobot_Lcd_UART lcd(stream);
+  lcd.begin();
+
+  // More frames than the batch buffer holds: sent in several writes, none lost or reordered
+  stream.clear();
+  for (uint8_t i = 0; i < 60; i++) {
+    lcd.drawPixel(i, i, 0x000000);
+  }
+  memcpy(immediate, stream.bytes, stream.len);
+  immediateLen = stream.len;
+  CHECK(immediateLen > LCD_BATCH_BUF_LEN);
+
+  stream.clear();
+  lcd.beginBatch();
+  for (uint8_t i = 0; i < 60; i++) {
+    lcd.drawPixel(i, i, 0x000000);
+  }
+  lcd.endBatch();
+  CHECK(sameAsImmediate());
+  CHECK(stream.writes > 1);
+  CHECK(stream.writes < 60);
+  for (uint16_t i = 0; i < stream.writes; i++) {
+    uint16_t start = i ? stream.writeEnd[i - 1] : 0;
+    CHECK(stream.writeEnd[i] - start <= LCD_BATCH_BUF_LEN);
+  }
+}
+
+static void testSettleFrame()
+{
+  DFRobot_Lcd_UART lcd(stream);
+  lcd.begin();
+
+  // cleanScreen() needs the module to settle: it goes out at once, behind what was collected before it
+  stream.clear();
+  lcd.beginBatch();
+  lcd.setBarValue(1, 1);
+  lcd.cleanScreen();
+  CHECK_EQ(stream.frames(), 2);
+  CHECK_EQ(stream.cmd(0), CMD_OF_DRAW_BAR_VALUE);
+  CHECK_EQ(stream.cmd(1), 0x1D);
+  lcd.setBarValue(1, 2);
+  lcd.endBatch();
+  CHECK_EQ(stream.frames(), 3);
+  CHECK_EQ(stream.cmd(2), CMD_OF_DRAW_BAR_VALUE);
+}
+
+static void testCoalesce()
+{
+  DFRobot_Lcd_UART lcd(stream);
+  lcd.begin();
+
+  // Only the last value of each object within a batch reaches the module, in its first slot
+  stream.clear();
+  lcd.beginBatch();
+  lcd.setBarValue(1, 10);
+  lcd.setGaugeValue(1, 20);
+  lcd.setBarValue(1, 11);
+  lcd.setBarValue(2, 30);
+  lcd.setBarValue(1, 12);
+  lcd.endBatch();
+  CHECK_EQ(stream.frames(), 3);
+  CHECK_EQ(stream.cmd(0), CMD_OF_DRAW_BAR_VALUE);
+  CHECK_EQ(stream.frame(0)[4], 1);
+  CHECK_EQ(stream.frame(0)[6], 12);
+  CHECK_EQ(stream.cmd(1), CMD_OF_DRAW_GAUGE_VALUE);
+  CHECK_EQ(stream.frame(2)[4], 2);
+  CHECK_EQ(lcd.getCoalescedCount(), 2);
+
+  // Outside a batch every call is sent
+  stream.clear();
+  lcd.setBarValue(1, 10);
+  lcd.setBarValue(1, 11);
+  CHECK_EQ(stream.frames(), 2);
+}
+
+static void testIic()
+{
+  DFRobot_Lcd_IIC lcd(&Wire, 0x2c);
+  lcd.begin();
+
+  Wire.clear();
+  hostDelayMs = 0;
+  dashboard(lcd, 7);
+  uint16_t transactions = Wire.transactions;
+  unsigned long delayMs = hostDelayMs;
+  memcpy(immediate, Wire.bytes, Wire.len);
+  immediateLen = Wire.len;
+
+  Wire.clear();
+  hostDelayMs = 0;
+  lcd.beginBatch();
+  dashboard(lcd, 7);
+  lcd.endBatch();
+  CHECK_EQ(Wire.len, immediateLen);
+  CHECK(memcmp(Wire.bytes, immediate, immediateLen) == 0);
+  // Every I2C transaction still gets its settle time, there are just fewer of them
+  CHECK(Wire.transactions < transactions);
+  CHECK_EQ(hostDelayMs, Wire.transactions * LCD_SETTLE_TIME_MS);
+  CHECK(hostDelayMs < delayMs);
+}
+
+int main()
+{
+  testUart();
+  testOverflow();
+  testSettleFrame();
+  testCoalesce();
+  testIic();
+  return TEST_DONE();
+}
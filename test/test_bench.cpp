@@ -0,0 +1,145 @@
+/*!
+ * @file test_bench.cpp
+ * @brief Per-API figures of examples/benchmark checked on the host: whole frames only, no heap, no sleeping
+ * @n With --json the figures are printed as JSON like the benchmark example prints them, for comparing two versions;
+ * @n time is left out as the host clock is simulated.
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "lcd_test.h"
+
+#define BENCH_CALLS  200
+
+static FakeStream stream;
+static DFRobot_Lcd_UART lcd(stream);
+static bool json = false;
+static bool first = true;
+
+static uint8_t id, lineId, iconId, sliderId, barId, chartId, seriesId, gaugeId, compassId, meterId, textId;
+static uint16_t points[8] = {10, 20, 30, 40, 50, 60, 70, 80};
+
+static void none() {}
+
+/**
+ * @brief Run call() calls times; before() and after() set up and clean up each run and are not counted
+ * @param settle Whether the call waits a fixed time for the module even with flow control (e.g. cleanScreen)
+ */
+static void bench(const char* method, void (*call)(), void (*after)() = none, void (*before)() = none,
+                  bool settle = false, uint16_t calls = BENCH_CALLS)
+{
+  unsigned long mallocs = 0, delayMs = 0;
+  uint32_t bytes = 0, writes = 0, frames = 0;
+  for (uint16_t i = 0; i < calls; i++) {
+    before();
+    stream.clear();
+    unsigned long m = hostMallocs, d = hostDelayMs;
+    call();
+    mallocs += hostMallocs - m;
+    delayMs += hostDelayMs - d;
+    bytes += stream.len;
+    writes += stream.writes;
+    frames += stream.frames();
+
+    // Whole, well-formed frames only: one per call, a few for calls like creatChart
+    uint16_t framed = 0;
+    for (uint16_t f = 0; f < stream.frames(); f++) {
+      const uint8_t* frame = stream.frame(f);
+      framed += ((frame[0] == 0x55) && (frame[1] == 0xAA)) ? frame[2] + 3 : 0;
+    }
+    if ((stream.frames() == 0) || (stream.frames() > 3) || (framed != stream.len)) {
+      printf("%s: call %u wrote %u bytes in %u frames\n", method, i, stream.len, stream.frames());
+      testFailures++;
+      break;
+    }
+    after();
+  }
+  if (mallocs) {
+    printf("%s: %lu heap allocations\n", method, mallocs);
+    testFailures++;
+  }
+  if (!settle && delayMs) {
+    printf("%s: slept %lu ms with flow control\n", method, delayMs);
+    testFailures++;
+  }
+
+  if (json) {
+    printf("%s{\"method\":\"%s\",\"frames\":%.1f,\"bytes\":%.1f,\"writes\":%.1f,\"delay_ms\":%.1f,\"allocs\":%lu}",
+           first ? "\n  " : ",\n  ", method, (float)frames / calls, (float)bytes / calls, (float)writes / calls,
+           (float)delayMs / calls, mallocs);
+    first = false;
+  }
+}
+
+int main(int argc, char** argv)
+{
+  json = (argc > 1) && (strcmp(argv[1], "--json") == 0);
+  stream.ack = true;
+  lcd.begin();
+  lcd.setFlowControl(true);
+
+  lineId = lcd.drawLine(10, 10, 100, 100, 2, 0xFF0000);
+  iconId = lcd.drawIcon(10, 10, lcd.eIconBee, 128);
+  sliderId = lcd.creatSlider(10, 10, 100, 20, 0xF800);
+  barId = lcd.creatBar(10, 40, 100, 20, 0x00FF00);
+  gaugeId = lcd.creatGauge(160, 10, 100, 0, 100, 0xFF0000, 0xFFFFFF);
+  compassId = lcd.creatCompass(160, 10, 100);
+  meterId = lcd.creatLineMeter(160, 120, 100, 0, 100, 0xFF0000, 0xFFFFFF);
+  textId = lcd.drawString(10, 200, "benchmark", 0, 0xFFFFFF);
+  chartId = lcd.creatChart("x", "y", 0xFFFFFF, 1);
+  seriesId = lcd.creatChartSeries(chartId, 0xFF0000);
+
+  if (json) {
+    printf("{\"calls\":%u,\"results\":[", BENCH_CALLS);
+  }
+  bench("setBackgroundColor", []() { lcd.setBackgroundColor(0); }, none, none, true, 3);
+  bench("setBackgroundImg", []() { lcd.setBackgroundImg(0, "bg.png"); });
+  bench("cleanScreen", []() { lcd.cleanScreen(); }, none, none, true, 3);
+  bench("drawPixel", []() { lcd.drawPixel(10, 10, 0xFF0000); });
+  bench("drawLine", []() { id = lcd.drawLine(10, 10, 100, 100, 2, 0xFF0000); }, []() { lcd.deleteLine(id); });
+  bench("updateLine", []() { lcd.updateLine(lineId, 20, 20, 120, 120, 3, 0x0000FF); }, none, none, true, 3);
+  bench("deleteLine", []() { lcd.deleteLine(id); }, none, []() { id = lcd.drawLine(10, 10, 100, 100, 2, 0xFF0000); });
+  bench("drawRect", []() { id = lcd.drawRect(10, 10, 100, 50, 2, 0xFF0000, 1, 0x0000FF, 1); }, []() { lcd.deleteRect(id); });
+  bench("drawCircle", []() { id = lcd.drawCircle(100, 100, 50, 2, 0xFF0000, 1, 0x0000FF); }, []() { lcd.deleteCircle(id); });
+  bench("drawTriangle", []() { id = lcd.drawTriangle(10, 10, 100, 10, 50, 80, 2, 0xFF0000, 1, 0x0000FF); }, []() { lcd.deleteTriangle(id); });
+  bench("drawIcon", []() { id = lcd.drawIcon(10, 10, lcd.eIconBee, 128); }, []() { lcd.deleteIcon(id); });
+  bench("drawIcon(path)", []() { id = lcd.drawIcon(10, 10, "S:/bee.png", 128); }, []() { lcd.deleteIcon(id); });
+  bench("setAngleIcon", []() { lcd.setAngleIcon(iconId, 90); });
+  bench("updateIcon", []() { lcd.updateIcon(iconId, 20, 20, lcd.eIconBee, 200); });
+  bench("updateIcon(path)", []() { lcd.updateIcon(iconId, 20, 20, "S:/bee.png", 200); });
+  bench("drawGif", []() { id = lcd.drawGif(10, 10, lcd.eGifSun, 128); }, []() { lcd.deleteGif(id); });
+  bench("drawGif(path)", []() { id = lcd.drawGif(10, 10, "S:/sun.gif", 128); }, []() { lcd.deleteGif(id); });
+  bench("creatSlider", []() { id = lcd.creatSlider(10, 10, 100, 20, 0xF800); }, []() { lcd.deleteSlider(id); });
+  bench("updateSlider", []() { lcd.updateSlider(sliderId, 20, 20, 100, 20, 0x001F); });
+  bench("setSliderValue", []() { lcd.setSliderValue(sliderId, 50); });
+  bench("creatBar", []() { id = lcd.creatBar(10, 40, 100, 20, 0x00FF00); }, []() { lcd.deleteBar(id); });
+  bench("updateBar", []() { lcd.updateBar(barId, 20, 40, 100, 20, 0x0000FF); });
+  bench("setBarValue", []() { lcd.setBarValue(barId, 50); });
+  bench("creatChart", []() { id = lcd.creatChart("x", "y", 0xFFFFFF, 1); }, []() { lcd.deleteChart(id); }, none, true, 3);
+  bench("updateChart", []() { lcd.updateChart(chartId, 0, 2); });
+  bench("updateChartSeries", []() { lcd.updateChartSeries(chartId, seriesId, 0x00FF00); });
+  bench("addChartSeriesData", []() { lcd.addChartSeriesData(chartId, seriesId, points, 8); });
+  bench("updateChartPoint", []() { lcd.updateChartPoint(chartId, seriesId, 1, 50); });
+  bench("setTopChart", []() { lcd.setTopChart(chartId); });
+  bench("creatGauge", []() { id = lcd.creatGauge(160, 10, 100, 0, 100, 0xFF0000, 0xFFFFFF); }, []() { lcd.deleteGauge(id); });
+  bench("updateGauge", []() { lcd.updateGauge(gaugeId, 170, 10, 100, 0, 100, 0x0000FF, 0xFFFFFF); });
+  bench("setGaugeValue", []() { lcd.setGaugeValue(gaugeId, 50); });
+  bench("creatCompass", []() { id = lcd.creatCompass(160, 10, 100); }, []() { lcd.deleteCompass(id); });
+  bench("updateCompass", []() { lcd.updateCompass(compassId, 170, 10, 100); });
+  bench("setCompassScale", []() { lcd.setCompassScale(compassId, 900); });
+  bench("creatLineMeter", []() { id = lcd.creatLineMeter(160, 120, 100, 0, 100, 0xFF0000, 0xFFFFFF); }, []() { lcd.deleteLineMeter(id); });
+  bench("updateLineMeter", []() { lcd.updateLineMeter(meterId, 170, 120, 100, 0, 100, 0x0000FF, 0xFFFFFF); });
+  bench("setMeterValue", []() { lcd.setMeterValue(meterId, 50); });
+  bench("setTopLineMeter", []() { lcd.setTopLineMeter(meterId); });
+  bench("drawString", []() { id = lcd.drawString(10, 200, "benchmark", 0, 0xFFFFFF); }, []() { lcd.deleteString(id); });
+  bench("updateString", []() { lcd.updateString(textId, 10, 200, "benchmark", 0, 0xFF0000); });
+  bench("drawStringf", []() { id = lcd.drawStringf(10, 200, 0, 0xFFFFFF, "%lums", millis()); }, []() { lcd.deleteString(id); });
+  bench("updateStringf", []() { lcd.updateStringf(textId, 10, 200, 0, 0xFF0000, "%lums", millis()); });
+  bench("drawLcdTime", []() { id = lcd.drawLcdTime(10, 200, 12, 34, 56, 0, 0xFFFF); }, []() { lcd.deleteString(id); });
+  bench("updateLcdTime", []() { lcd.updateLcdTime(textId, 10, 200, 12, 34, 56, 0, 0xFFFF); });
+  if (json) {
+    printf("\n]}\n");
+  }
+
+  return json ? testFailures : TEST_DONE();
+}
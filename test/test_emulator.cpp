@@ -0,0 +1,145 @@
+/*!
+ * @file test_emulator.cpp
+ * @brief The library driving DFRobot_LcdEmulator: every frame the module accepts, objects created and deleted as expected
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "lcd_test.h"
+#include "DFRobot_LcdEmulator.h"
+
+typedef DFRobot_LcdDisplayT<DFRobot_LcdEmulator> EmuDisplay;
+
+/**
+ * @brief Create one object of every type, change each, then delete them again
+ */
+static void drawAll(EmuDisplay& lcd)
+{
+  DFRobot_LcdEmulator& emu = lcd.transport();
+  uint16_t points[5] = {1, 300, 65535, 4, 5};
+
+  lcd.setBackgroundColor(0x123456);
+  lcd.cleanScreen();
+  lcd.drawPixel(10, 20, 0xABCDEF);
+  uint8_t line = lcd.drawLine(1, 2, 300, 4, 3, 0x102030);
+  lcd.updateLine(line, 5, 6, 7, 8, 2, 0x405060);
+  uint8_t rect = lcd.drawRect(10, 20, 30, 40, 2, 0x111111, 1, 0x222222, 1);
+  uint8_t circle = lcd.drawCircle(100, 110, 50, 2, 0x555555, 1, 0x666666);
+  uint8_t triangle = lcd.drawTriangle(1, 2, 3, 4, 5, 6, 1, 0x999999, 1, 0xaaaaaa);
+  uint8_t icon = lcd.drawIcon(10, 20, lcd.eIconBee, 300);
+  lcd.setAngleIcon(icon, -90);
+  uint8_t pathIcon = lcd.drawIcon(10, 20, "U:/a.png", 256);
+  lcd.updateIcon(pathIcon, 1, 2, "U:/bb.png", 128);
+  uint8_t gif = lcd.drawGif(3, 4, lcd.eGifSun, 200);
+  uint8_t slider = lcd.creatSlider(1, 2, 300, 20, 0xF800);
+  lcd.setSliderValue(slider, 50);
+  uint8_t bar = lcd.creatBar(1, 2, 300, 20, 0x123456);
+  lcd.setBarValue(bar, 99);
+  uint8_t chart = lcd.creatChart("a b c", "1 2 3", 0x010203, 1);
+  uint8_t series = lcd.creatChartSeries(chart, 0xff00ff);
+  lcd.addChartSeriesData(chart, series, points, 5);
+  lcd.updateChartPoint(chart, series, 3, 777);
+  lcd.setTopChart(chart);
+  uint8_t gauge = lcd.creatGauge(1, 2, 100, 0, 360, 0x111111, 0x222222);
+  lcd.setGaugeValue(gauge, 300);
+  uint8_t compass = lcd.creatCompass(1, 2, 100);
+  lcd.setCompassScale(compass, 270);
+  uint8_t meter = lcd.creatLineMeter(1, 2, 100, 0, 100, 0x111111, 0x222222);
+  lcd.setMeterValue(meter, 50);
+  uint8_t text = lcd.drawString(10, 20, "Hello", 0, 0xFFFFFF);
+  lcd.updateString(text, 11, 21, "World!", 1, 0x000001);
+  pumpQueue(lcd);
+
+  // line, rect, circle, triangle, two icons, gif, slider, bar, chart, series, gauge, compass, meter, text
+  CHECK_EQ(emu.getObjectCount(), 15);
+  CHECK(emu.isAlive(CMD_OF_DRAW_ICON_INTERNAL, pathIcon));
+  CHECK(emu.isAlive(CMD_OF_DRAW_SERIE, series));
+
+  lcd.deleteLine(line);
+  lcd.deleteRect(rect);
+  lcd.deleteCircle(circle);
+  lcd.deleteTriangle(triangle);
+  lcd.deleteIcon(icon);
+  lcd.deleteIcon(pathIcon);
+  lcd.deleteGif(gif);
+  lcd.deleteSlider(slider);
+  lcd.deleteBar(bar);
+  lcd.deleteGauge(gauge);
+  lcd.deleteCompass(compass);
+  lcd.deleteLineMeter(meter);
+  lcd.deleteString(text);
+  pumpQueue(lcd);
+  CHECK_EQ(emu.getObjectCount(), 2);
+  CHECK(emu.isAlive(CMD_OF_DRAW_LINE_CHART, chart));
+
+  lcd.deleteChart(chart);
+  lcd.cleanScreen();
+  pumpQueue(lcd);
+  CHECK_EQ(emu.getObjectCount(), 0);
+  CHECK_EQ(emu.getErrorCount(), 0);
+}
+
+static void testImmediate()
+{
+  EmuDisplay lcd(DFRobot_LcdEmulator(DFRobot_LcdEmulator::eEmuLinkUART, 115200));
+  lcd.begin();
+  drawAll(lcd);
+}
+
+static void testFlowControl()
+{
+  EmuDisplay lcd(DFRobot_LcdEmulator(DFRobot_LcdEmulator::eEmuLinkI2C, 400000));
+  lcd.begin();
+  lcd.transport().setAck(true);
+  lcd.setFlowControl(true);
+  drawAll(lcd);
+}
+
+/**
+ * @brief Async mode packs several frames into one write, which the module model counts as overruns with its
+ * @n estimated processing times; without them only the order of the frames is checked
+ */
+static void testAsync()
+{
+  EmuDisplay lcd(DFRobot_LcdEmulator(DFRobot_LcdEmulator::eEmuLinkUART, 115200));
+  DFRobot_LcdEmulator& emu = lcd.transport();
+  for (uint8_t cmd = 0; cmd < LCD_EMU_CMD_NUM; cmd++) {
+    emu.setProcessTime(cmd, 0);
+  }
+  lcd.begin();
+  lcd.setAsync(true);
+  drawAll(lcd);
+
+  // A value must not reach the module before the object it is about, also for icons from a path
+  lcd.creatBar(1, 2, 300, 20, 0x123456);
+  uint8_t icon = lcd.drawIcon(10, 20, "U:/a.png", 256);
+  lcd.setAngleIcon(icon, 90);
+  pumpQueue(lcd);
+  CHECK_EQ(emu.getErrorCount(), 0);
+  CHECK_EQ(emu.getObjectCount(), 2);
+  CHECK(emu.isAlive(CMD_OF_DRAW_ICON_EXTERNAL, icon));
+}
+
+static void testBadFrames()
+{
+  EmuDisplay lcd(DFRobot_LcdEmulator(DFRobot_LcdEmulator::eEmuLinkUART, 115200));
+  lcd.begin();
+  DFRobot_LcdEmulator& emu = lcd.transport();
+
+  // Reported through getLastError() and getErrorCount() only, nothing is printed
+  Serial.output.clear();
+  lcd.setBarValue(9, 50);
+  CHECK_EQ(emu.getLastError(), DFRobot_LcdEmulator::eEmuNoObject);
+  lcd.deleteGauge(9);
+  CHECK_EQ(emu.getErrorCount(), 2);
+  CHECK(Serial.output.empty());
+}
+
+int main()
+{
+  testImmediate();
+  testFlowControl();
+  testAsync();
+  testBadFrames();
+  return TEST_DONE();
+}
@@ -0,0 +1,42 @@
+/*!
+ * @file test_flow.cpp
+ * @brief ACK flow control: no fixed sleep when the module answers, a counted timeout when it does not
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+// build: -DLCD_ENABLE_STATS=1
+#include "lcd_test.h"
+
+int main()
+{
+  FakeStream stream;
+  DFRobot_Lcd_UART lcd(stream);
+  lcd.begin();
+  lcd.setFlowControl(true, 20);
+
+  // The module acknowledges every frame: nothing sleeps
+  stream.ack = true;
+  lcd.resetStats();
+  hostDelayMs = 0;
+  for (uint8_t i = 0; i < 10; i++) {
+    lcd.setBarValue(1, i);
+  }
+  CHECK_EQ(stream.frames(), 10);
+  CHECK_EQ(hostDelayMs, 0);
+  CHECK_EQ(lcd.getStats().ackTimeouts, 0);
+
+  // No answer: each frame waits out the timeout, which is counted and not printed
+  stream.ack = false;
+  stream.clear();
+  unsigned long start = millis();
+  for (uint8_t i = 0; i < 10; i++) {
+    lcd.setBarValue(1, i);
+  }
+  CHECK_EQ(stream.frames(), 10);
+  CHECK(millis() - start >= 10 * 20);
+  CHECK_EQ(lcd.getStats().ackTimeouts, 10);
+  CHECK(Serial.output.empty());
+
+  return TEST_DONE();
+}
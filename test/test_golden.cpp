@@ -0,0 +1,200 @@
+/*!
+ * @file test_golden.cpp
+ * @brief Every API call writes the bytes recorded in golden_frames.txt, in every transmit mode
+ * @n The golden frames were captured from the library before the encoders were rewritten; a change to
+ * @n them is a change of the wire protocol. After an intended change, rewrite the file with --update.
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "lcd_test.h"
+
+#define GOLDEN_FILE   "golden_frames.txt"
+#define MAX_STEPS     80
+#define MAX_LINE      640
+
+enum eMode_t {
+  eImmediate,
+  eBatch,
+  eAsync,
+  eFlow,
+  eFlowAsync,
+  eTemplate,
+  eModeNum
+};
+static const char* modeNames[eModeNum] = {"immediate", "batch", "async", "flow control", "flow control + async",
+                                          "DFRobot_LcdDisplayT"};
+
+static char lines[MAX_STEPS][MAX_LINE];
+static uint8_t steps;
+static uint8_t reference[FakeStream::MAX_BYTES];
+static uint16_t referenceLen;
+
+/**
+ * @brief Record the bytes written since the last step as one "label hex" line
+ */
+static void step(DFRobot_LcdDisplay& lcd, FakeStream& stream, uint16_t& mark, const char* label)
+{
+  pumpQueue(lcd);
+  if (steps >= MAX_STEPS) {
+    return;
+  }
+  int n = snprintf(lines[steps], MAX_LINE, "%s ", label);
+  for (uint16_t i = mark; (i < stream.len) && (n + 3 < MAX_LINE); i++) {
+    n += snprintf(lines[steps] + n, MAX_LINE - n, "%02x", stream.bytes[i]);
+  }
+  mark = stream.len;
+  steps++;
+}
+
+static void run(eMode_t mode, DFRobot_LcdDisplay& lcd, FakeStream& stream)
+{
+  uint16_t mark = 0;
+  steps = 0;
+  if ((mode == eAsync) || (mode == eFlowAsync)) {
+    lcd.setAsync(true);
+  }
+  if ((mode == eFlow) || (mode == eFlowAsync)) {
+    stream.ack = true;
+    lcd.setFlowControl(true, 50);
+  }
+  if (mode == eBatch) {
+    lcd.beginBatch();
+  }
+  #define STEP(call) call; step(lcd, stream, mark, #call)
+  #define STEP_ID(var, call) uint8_t var = call; step(lcd, stream, mark, #call)
+
+  STEP(lcd.setBackgroundColor(0x123456));
+  STEP(lcd.setBackgroundImg(1, "bg.png"));
+  STEP(lcd.cleanScreen());
+  STEP(lcd.drawPixel(330, 250, 0xABCDEF));
+  STEP(lcd.drawPixel(-5, 7, 0xABCDEF));
+  STEP_ID(line, lcd.drawLine(1, 2, 300, -4, 3, 0x102030));
+  STEP(lcd.updateLine(line, 5, 6, 7, 8, 2, 0x405060));
+  STEP(lcd.drawLine(1, 2, 3, 4, 3, 1));
+  STEP(lcd.deleteLine(line));
+  STEP(lcd.drawLine(1, 2, 3, 4, 3, 1));
+  STEP_ID(rect, lcd.drawRect(10, 20, 30, 40, 2, 0x111111, 1, 0x222222, 1));
+  STEP(lcd.updateRect(rect, 11, 21, 31, 41, 3, 0x333333, 0, 0x444444, 0));
+  STEP(lcd.deleteRect(rect));
+  STEP_ID(circle, lcd.drawCircle(100, 110, 50, 2, 0x555555, 1, 0x666666));
+  STEP(lcd.updateCircle(circle, 101, 111, 51, 3, 0x777777, 0, 0x888888));
+  STEP(lcd.deleteCircle(circle));
+  STEP_ID(triangle, lcd.drawTriangle(1, 2, 3, 4, 5, 6, 1, 0x999999, 1, 0xaaaaaa));
+  STEP(lcd.updateTriangle(triangle, -1, -2, -3, -4, -5, -6, 2, 0xbbbbbb, 0, 0xcccccc));
+  STEP(lcd.deleteTriangle(triangle));
+  STEP_ID(icon, lcd.drawIcon(10, 20, lcd.eIconBee, 300));
+  STEP_ID(pathIcon, lcd.drawIcon(10, 20, "U:/a.png", 256));
+  STEP(lcd.setAngleIcon(icon, -90));
+  STEP(lcd.updateIcon(icon, 1, 2, 5, 128));
+  STEP(lcd.updateIcon(pathIcon, 1, 2, "U:/bb.png", 128));
+  STEP(lcd.deleteIcon(icon));
+  STEP_ID(gif, lcd.drawGif(3, 4, lcd.eGifSun, 200));
+  STEP(lcd.drawGif(3, 4, "U:/a.gif", 200));
+  STEP(lcd.deleteGif(gif));
+  STEP_ID(slider, lcd.creatSlider(1, 2, 300, 20, 0xF800));
+  STEP(lcd.updateSlider(slider, 2, 3, 301, 21, 0x07E0));
+  STEP(lcd.setSliderValue(slider, 513));
+  STEP(lcd.deleteSlider(slider));
+  STEP_ID(bar, lcd.creatBar(1, 2, 300, 20, 0x123456));
+  STEP(lcd.updateBar(bar, 2, 3, 301, 21, 0x654321));
+  STEP(lcd.setBarValue(bar, 999));
+  STEP(lcd.deleteBar(bar));
+  STEP_ID(chart, lcd.creatChart("a b c", "1 2 3", 0x010203, 1));
+  STEP(lcd.updateChart(chart, 0x030201, 2));
+  STEP_ID(series, lcd.creatChartSeries(chart, 0xff00ff));
+  STEP(lcd.updateChartSeries(chart, series, 0x00ff00));
+  uint16_t points[5] = {1, 300, 65535, 4, 5};
+  STEP(lcd.addChartSeriesData(chart, series, points, 5));
+  STEP(lcd.updateChartPoint(chart, series, 3, 777));
+  STEP(lcd.setTopChart(chart));
+  STEP(lcd.deleteChart(chart));
+  STEP_ID(gauge, lcd.creatGauge(1, 2, 100, 0, 360, 0x111111, 0x222222));
+  STEP(lcd.updateGauge(gauge, 2, 3, 101, 1, 361, 0x333333, 0x444444));
+  STEP(lcd.setGaugeValue(gauge, 300));
+  STEP(lcd.deleteGauge(gauge));
+  STEP_ID(compass, lcd.creatCompass(1, 2, 100));
+  STEP(lcd.updateCompass(compass, 2, 3, 101));
+  STEP(lcd.setCompassScale(compass, 270));
+  STEP(lcd.deleteCompass(compass));
+  STEP_ID(meter, lcd.creatLineMeter(1, 2, 100, 0, 100, 0x111111, 0x222222));
+  STEP(lcd.updateLineMeter(meter, 2, 3, 101, 1, 101, 0x333333, 0x444444));
+  STEP(lcd.setMeterValue(meter, 50));
+  STEP(lcd.setTopLineMeter(meter));
+  STEP(lcd.deleteLineMeter(meter));
+  STEP_ID(text, lcd.drawString(10, 20, "Hello", 0, 0xFFFFFF));
+  STEP(lcd.updateString(text, 11, 21, "World!", 1, 0x000001));
+  STEP(lcd.deleteString(text));
+  STEP_ID(time, lcd.drawLcdTime(10, 20, 9, 8, 7, 0, 0xFFFF));
+  STEP(lcd.updateLcdTime(time, 10, 20, 19, 58, 57, 0, 0xFFFF));
+  STEP(lcd.drawLcdDate(10, 20, 3, 29, 3, 0, 0xFFFF));
+
+  #undef STEP
+  #undef STEP_ID
+  if (mode == eBatch) {
+    lcd.endBatch();
+  }
+}
+
+int main(int argc, char** argv)
+{
+  static FakeStream streams[eModeNum];
+  bool update = (argc > 1) && (strcmp(argv[1], "--update") == 0);
+
+  DFRobot_Lcd_UART immediate(streams[eImmediate]);
+  immediate.begin();
+  run(eImmediate, immediate, streams[eImmediate]);
+  referenceLen = streams[eImmediate].len;
+  memcpy(reference, streams[eImmediate].bytes, referenceLen);
+
+  if (update) {
+    FILE* file = fopen(GOLDEN_FILE, "w");
+    for (uint8_t i = 0; i < steps; i++) {
+      fprintf(file, "%s\n", lines[i]);
+    }
+    fclose(file);
+    printf("wrote %u steps to %s\n", steps, GOLDEN_FILE);
+    return 0;
+  }
+
+  // Call by call against the file
+  FILE* file = fopen(GOLDEN_FILE, "r");
+  CHECK(file != NULL);
+  static char golden[MAX_LINE + 2];
+  uint8_t i = 0;
+  while (file && fgets(golden, sizeof(golden), file)) {
+    golden[strcspn(golden, "\r\n")] = 0;
+    if (i >= steps) {
+      printf("%s: extra golden line %s\n", GOLDEN_FILE, golden);
+      testFailures++;
+    } else if (strcmp(golden, lines[i]) != 0) {
+      printf("%s:%u: expected\n  %s\ngot\n  %s\n", GOLDEN_FILE, i + 1, golden, lines[i]);
+      testFailures++;
+    }
+    i++;
+  }
+  CHECK_EQ(i, steps);
+  if (file) {
+    fclose(file);
+  }
+
+  // The other modes and the template display change when and in how many writes the bytes go out, never which bytes
+  for (uint8_t mode = eBatch; mode < eModeNum; mode++) {
+    if (mode == eTemplate) {
+      DFRobot_LcdDisplayT<DFRobot_LcdStreamTransport> lcd((DFRobot_LcdStreamTransport(streams[mode])));
+      lcd.begin();
+      run((eMode_t)mode, lcd, streams[mode]);
+    } else {
+      DFRobot_Lcd_UART lcd(streams[mode]);
+      lcd.begin();
+      run((eMode_t)mode, lcd, streams[mode]);
+    }
+    if ((streams[mode].len != referenceLen) || memcmp(streams[mode].bytes, reference, referenceLen)) {
+      printf("%s mode writes %u bytes that differ from immediate mode (%u bytes)\n",
+             modeNames[mode], streams[mode].len, referenceLen);
+      testFailures++;
+    }
+  }
+
+  return TEST_DONE();
+}
@@ -0,0 +1,65 @@
+/*!
+ * @file test_iic.cpp
+ * @brief DFRobot_Lcd_IIC: clock probing picks the fastest rate the module acknowledges, without printing;
+ * @n a short text is one transaction, through the subclass and through DFRobot_LcdWireTransport alike
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "lcd_test.h"
+
+/**
+ * @brief A bus on which the module stops acknowledging above 400 kHz
+ */
+class SlowWire : public TwoWire
+{
+public:
+  uint8_t endTransmission(bool stop = true)
+  {
+    TwoWire::endTransmission(stop);
+    return (clock > 400000) ? 2 : 0;
+  }
+};
+
+int main()
+{
+  SlowWire wire;
+  DFRobot_Lcd_IIC lcd(&wire, 0x2c);
+  lcd.begin();
+
+  CHECK_EQ(lcd.probeClock(), 400000);
+  CHECK_EQ(lcd.getClock(), 400000);
+  CHECK_EQ(wire.clock, 400000);
+  CHECK_EQ(lcd.probeClock(100000), 100000);
+  CHECK(Serial.output.empty());
+
+  DFRobot_Lcd_IIC fast(&Wire, 0x2c);
+  CHECK(fast.begin(LCD_I2C_CLOCK_AUTO));
+  CHECK_EQ(fast.getClock(), 1000000);
+  CHECK(Serial.output.empty());
+
+  // Header and text are held apart but go out together
+  TwoWire wireIIC, wireT;
+  DFRobot_Lcd_IIC iic(&wireIIC, 0x2c);
+  DFRobot_LcdDisplayT<DFRobot_LcdWireTransport> templ((DFRobot_LcdWireTransport(&wireT, 0x2c)));
+  iic.drawString(10, 20, "Hello", 0, 0xFFFFFF);
+  templ.drawString(10, 20, "Hello", 0, 0xFFFFFF);
+  CHECK_EQ(wireIIC.transactions, 1);
+  CHECK_EQ(wireT.transactions, 1);
+  CHECK_EQ(wireT.len, wireIIC.len);
+  CHECK(memcmp(wireT.bytes, wireIIC.bytes, wireIIC.len) == 0);
+
+  // A text longer than a transaction is split where a frame in one buffer would be
+  static char longText[100];
+  memset(longText, 'x', sizeof(longText) - 1);
+  wireIIC.clear();
+  wireT.clear();
+  iic.drawString(10, 20, longText, 0, 0xFFFFFF);
+  templ.drawString(10, 20, longText, 0, 0xFFFFFF);
+  CHECK_EQ(wireT.transactions, wireIIC.transactions);
+  CHECK_EQ(wireT.transactions, (wireT.len + BUFFER_LENGTH - 1) / BUFFER_LENGTH);
+  CHECK(memcmp(wireT.end, wireIIC.end, wireIIC.transactions * sizeof(wireIIC.end[0])) == 0);
+  CHECK(memcmp(wireT.bytes, wireIIC.bytes, wireIIC.len) == 0);
+
+  return TEST_DONE();
+}
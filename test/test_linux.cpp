@@ -0,0 +1,153 @@
+/*!
+ * @file test_linux.cpp
+ * @brief Linux transports against a pseudo terminal standing in for the module, and against a missing I2C bus
+ * @n Built without the Arduino stand-in, on the library's POSIX layer, as a program on a Linux board would be.
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+// build: -DLCD_ENABLE_STATS=1
+// core: posix
+#include "DFRobot_LcdDisplay.h"
+#include "check.h"
+#include <pty.h>
+#include <unistd.h>
+#include <thread>
+#include <atomic>
+
+typedef DFRobot_LcdDisplayT<DFRobot_LcdTermiosTransport> TermiosDisplay;
+
+/**
+ * @brief Module side of the pty: acknowledges the first `expect` frames it receives, then stops reading
+ */
+class FakeModule
+{
+public:
+  std::atomic<int> frames;
+
+  FakeModule(int fd, int expect) : frames(0), _fd(fd), _expect(expect), _thread(&FakeModule::run, this) {}
+  ~FakeModule() { _thread.join(); }
+
+  /**
+   * @brief Wait up to one second of real time for all expected frames
+   */
+  bool waitFrames()
+  {
+    for (int i = 0; (i < 1000) && (frames < _expect); i++) {
+      usleep(1000);
+    }
+    return frames == _expect;
+  }
+
+private:
+  int _fd;
+  int _expect;
+  std::thread _thread;
+
+  void run()
+  {
+    uint8_t frame[LCD_FRAME_MAX_LEN + CMDLEN_OF_HEAD_LEN];
+    uint16_t len = 0;
+    uint8_t data;
+    while ((frames < _expect) && (::read(_fd, &data, 1) == 1)) {
+      if (((len == 0) && (data != CMD_HEADER_HIGH)) || ((len == 1) && (data != CMD_HEADER_LOW))) {
+        len = 0;
+        continue;
+      }
+      frame[len++] = data;
+      if ((len > 2) && (len == frame[2] + CMDLEN_OF_HEAD_LEN)) {
+        uint8_t ack[4] = {CMD_HEADER_HIGH, CMD_HEADER_LOW, 0x01, frame[3]};
+        if (::write(_fd, ack, sizeof(ack)) != sizeof(ack)) {
+          break;
+        }
+        frames++;
+        len = 0;
+      }
+    }
+  }
+};
+
+static void testTermios()
+{
+  int master, slave;
+  char name[64];
+  CHECK(openpty(&master, &slave, name, NULL, NULL) == 0);
+  FakeModule module(master, 22);
+
+  TermiosDisplay lcd(DFRobot_LcdTermiosTransport(name, 115200));
+  CHECK(lcd.begin());
+  uint8_t bar = lcd.creatBar(1, 2, 300, 20, 0x123456);
+  for (uint8_t i = 0; i < 20; i++) {
+    lcd.setBarValue(bar, i);
+  }
+  // Header and text are gathered into one writev()
+  uint32_t chunks = lcd.getStats().chunks;
+  lcd.drawString(10, 20, "Hello", 0, 0xFFFFFF);
+  CHECK_EQ(lcd.getStats().chunks, chunks + 1);
+  CHECK(module.waitFrames());
+
+  // The acknowledgements come back through read()
+  uint8_t ack[4 * 22];
+  uint16_t got = 0;
+  for (int i = 0; (i < 1000) && (got < sizeof(ack)); i++) {
+    got += lcd.transport().read(ack + got, sizeof(ack) - got);
+    usleep(1000);
+  }
+  CHECK_EQ(got, sizeof(ack));
+  CHECK_EQ(ack[3], CMD_OF_DRAW_BAR);
+  CHECK_EQ(ack[7], CMD_OF_DRAW_BAR_VALUE);
+  CHECK_EQ(ack[4 * 21 + 3], CMD_OF_DRAW_TEXT);
+
+  // Close the module side: writes fail, and the display drops the frame instead of retrying forever
+  close(master);
+  uint8_t frame[] = {CMD_HEADER_HIGH, CMD_HEADER_LOW, 0x01, 0x1D};
+  CHECK_EQ(lcd.transport().write(frame, sizeof(frame)), 0);
+  uint32_t failed = lcd.getStats().failedTransactions;
+  lcd.setBarValue(bar, 99);
+  CHECK_EQ(lcd.getStats().failedTransactions, failed + 1);
+  lcd.transport().end();
+  close(slave);
+}
+
+static void testTermiosFull()
+{
+  int master, slave;
+  char name[64];
+  CHECK(openpty(&master, &slave, name, NULL, NULL) == 0);
+  DFRobot_LcdTermiosTransport port(name, 115200);
+  CHECK(port.begin());
+
+  // Nobody reads the module side: once the pty is full, write() gives up and reports how much it took
+  static uint8_t buf[4096];
+  memset(buf, 0x55, sizeof(buf));
+  uint16_t sent = sizeof(buf);
+  for (int i = 0; (i < 1000) && (sent == sizeof(buf)); i++) {
+    sent = port.write(buf, sizeof(buf));
+  }
+  CHECK(sent < sizeof(buf));
+  port.end();
+  close(master);
+  close(slave);
+}
+
+static void testI2cDev()
+{
+  DFRobot_LcdI2cDevTransport missing("/dev/i2c-does-not-exist", 0x2c);
+  CHECK(!missing.begin());
+  uint8_t frame[] = {CMD_HEADER_HIGH, CMD_HEADER_LOW, 0x01, 0x1D};
+  CHECK_EQ(missing.write(frame, sizeof(frame)), 0);
+  CHECK_EQ(missing.write(frame, 2, frame + 2, 2), 0);
+  CHECK_EQ(missing.read(frame, sizeof(frame)), 0);
+
+  // Not an I2C bus: the address check fails
+  DFRobot_LcdI2cDevTransport notBus("/dev/null", 0x2c);
+  CHECK(!notBus.begin());
+}
+
+int main()
+{
+  testTermios();
+  testTermiosFull();
+  testI2cDev();
+  return TEST_DONE();
+}
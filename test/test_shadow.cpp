@@ -0,0 +1,47 @@
+/*!
+ * @file test_shadow.cpp
+ * @brief Shadow cache: unchanged updates are skipped, anything that changes what is on screen goes out
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "lcd_test.h"
+
+int main()
+{
+  FakeStream stream;
+  DFRobot_Lcd_UART lcd(stream);
+  lcd.begin();
+  lcd.setShadowCache(true);
+
+  // The same value twice is sent once
+  uint8_t bar = lcd.creatBar(1, 2, 300, 20, 0x123456);
+  stream.clear();
+  lcd.setBarValue(bar, 10);
+  lcd.setBarValue(bar, 10);
+  lcd.setBarValue(bar, 11);
+  CHECK_EQ(stream.frames(), 2);
+  CHECK_EQ(lcd.getShadowHits(), 1);
+
+  // Deleting and redrawing the object starts over
+  lcd.deleteBar(bar);
+  bar = lcd.creatBar(1, 2, 300, 20, 0x123456);
+  stream.clear();
+  lcd.setBarValue(bar, 11);
+  CHECK_EQ(stream.frames(), 1);
+
+  // An icon switching between a built-in image and one from a path is one object
+  uint8_t icon = lcd.drawIcon(10, 20, lcd.eIconBee, 256);
+  stream.clear();
+  lcd.updateIcon(icon, 10, 20, lcd.eIconBee, 256);
+  CHECK_EQ(stream.frames(), 0);
+  lcd.updateIcon(icon, 10, 20, "U:/b.png", 256);
+  lcd.updateIcon(icon, 10, 20, lcd.eIconBee, 256);
+  lcd.updateIcon(icon, 10, 20, "U:/b.png", 256);
+  CHECK_EQ(stream.frames(), 3);
+  CHECK_EQ(stream.cmd(0), CMD_OF_DRAW_ICON_EXTERNAL);
+  CHECK_EQ(stream.cmd(1), CMD_OF_DRAW_ICON_INTERNAL);
+  CHECK_EQ(stream.cmd(2), CMD_OF_DRAW_ICON_EXTERNAL);
+
+  return TEST_DONE();
+}
@@ -0,0 +1,97 @@
+/*!
+ * @file test_trace.cpp
+ * @brief DFRobot_LcdRecorder traces replayed through replay(): the same bytes again, and cut-off traces reported
+ * @copyright   Copyright (c) 2010 DFRobot Co.Ltd (http://www.dfrobot.com)
+ * @License     The MIT License (MIT)
+ * @url https://github.com/DFRobot/DFRobot_LcdDisplay
+ */
+#include "lcd_test.h"
+
+typedef DFRobot_LcdRecorder<DFRobot_LcdStreamTransport> Recorder;
+
+/**
+ * @brief A trace in memory: written through Print, read back through Stream
+ */
+class TraceBuffer : public Stream
+{
+public:
+  static const uint16_t MAX_BYTES = 4096;
+
+  uint8_t bytes[MAX_BYTES];
+  uint16_t len = 0;
+  uint16_t pos = 0;
+
+  size_t write(uint8_t data)
+  {
+    if (len < MAX_BYTES) {
+      bytes[len++] = data;
+    }
+    return 1;
+  }
+  int available() { return len - pos; }
+  int read() { return (pos < len) ? bytes[pos++] : -1; }
+  int peek() { return (pos < len) ? bytes[pos] : -1; }
+};
+
+static FakeStream recorded;
+static FakeStream replayed;
+static TraceBuffer trace;
+
+static void record()
+{
+  DFRobot_LcdDisplayT<Recorder> lcd(Recorder(trace, DFRobot_LcdStreamTransport(recorded)));
+  lcd.begin();
+  uint8_t bar = lcd.creatBar(1, 2, 300, 20, 0x123456);
+  lcd.setBarValue(bar, 50);
+  uint8_t text = lcd.drawString(10, 20, "Hello", 0, 0xFFFFFF);
+  lcd.updateString(text, 11, 21, "World!", 1, 0x000001);
+  lcd.deleteBar(bar);
+  CHECK_EQ(lcd.transport().getFrameCount(), 5);
+}
+
+static void replayAll()
+{
+  DFRobot_Lcd_UART lcd(replayed);
+  lcd.begin();
+  trace.pos = 0;
+  CHECK_EQ(lcd.replay(trace), 5);
+  CHECK_EQ(lcd.getLastError(), DFRobot_LcdDisplay::eLcdOK);
+  CHECK_EQ(replayed.len, recorded.len);
+  CHECK(memcmp(replayed.bytes, recorded.bytes, recorded.len) == 0);
+}
+
+static void replayCut()
+{
+  uint16_t full = trace.len;
+  DFRobot_Lcd_UART lcd(replayed);
+  lcd.begin();
+
+  // Cut inside the last frame: four frames go out, then the error
+  trace.len = full - 1;
+  trace.pos = 0;
+  Serial.output.clear();
+  CHECK_EQ(lcd.replay(trace), 4);
+  CHECK_EQ(lcd.getLastError(), DFRobot_LcdDisplay::eLcdBadTrace);
+  CHECK(Serial.output.empty());
+
+  // Cut inside a timestamp
+  trace.len = 2;
+  trace.pos = 0;
+  CHECK_EQ(lcd.replay(trace), 0);
+  CHECK_EQ(lcd.getLastError(), DFRobot_LcdDisplay::eLcdBadTrace);
+
+  // Not a frame where one should start
+  trace.len = full;
+  trace.bytes[LCD_TRACE_STAMP_LEN] = 0;
+  trace.pos = 0;
+  CHECK_EQ(lcd.replay(trace), 0);
+  CHECK_EQ(lcd.getLastError(), DFRobot_LcdDisplay::eLcdBadTrace);
+}
+
+int main()
+{
+  record();
+  replayAll();
+  replayCut();
+  return TEST_DONE();
+}